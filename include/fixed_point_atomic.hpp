@@ -0,0 +1,254 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+/*
+    atomic fixed value. fixed is a single integer, so this is a std::atomic of int_type and
+    load, store, exchange, fetch_add and fetch_sub are the native atomic instructions.
+    fetch_max and fetch_min are compare exchange loops which stop as soon as the stored value already wins.
+    addition wraps on overflow like the atomic integer does.
+*/
+template<typename T, size_t fraction>
+class atomic_fixed{
+    static_assert(std::is_integral_v<T>, "atomic_fixed needs a builtin integer type");
+
+public:
+    using value_type = fixed<T, fraction>;
+
+    constexpr static bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+    constexpr atomic_fixed() : value(0){
+    }
+
+    constexpr atomic_fixed(value_type x) : value(x.v){
+    }
+
+    atomic_fixed(const atomic_fixed&) = delete;
+    atomic_fixed& operator=(const atomic_fixed&) = delete;
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const{
+        return fp_from_bits<T, fraction>(value.load(order));
+    }
+
+    void store(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        value.store(x.v, order);
+    }
+
+    value_type exchange(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        return fp_from_bits<T, fraction>(value.exchange(x.v, order));
+    }
+
+    bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order order = std::memory_order_seq_cst){
+        return value.compare_exchange_weak(expected.v, desired.v, order);
+    }
+
+    bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order order = std::memory_order_seq_cst){
+        return value.compare_exchange_strong(expected.v, desired.v, order);
+    }
+
+    value_type fetch_add(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        return fp_from_bits<T, fraction>(value.fetch_add(x.v, order));
+    }
+
+    value_type fetch_sub(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        return fp_from_bits<T, fraction>(value.fetch_sub(x.v, order));
+    }
+
+    //stores max(current, x) and returns the previous value
+    value_type fetch_max(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        T current = value.load(std::memory_order_relaxed);
+        while(current < x.v and not value.compare_exchange_weak(current, x.v, order, std::memory_order_relaxed)){
+        }
+        return fp_from_bits<T, fraction>(current);
+    }
+
+    //stores min(current, x) and returns the previous value
+    value_type fetch_min(value_type x, std::memory_order order = std::memory_order_seq_cst){
+        T current = value.load(std::memory_order_relaxed);
+        while(current > x.v and not value.compare_exchange_weak(current, x.v, order, std::memory_order_relaxed)){
+        }
+        return fp_from_bits<T, fraction>(current);
+    }
+
+    value_type operator+=(value_type x){
+        return fetch_add(x) + x;
+    }
+
+    value_type operator-=(value_type x){
+        return fetch_sub(x) - x;
+    }
+
+    operator value_type() const{
+        return load();
+    }
+
+private:
+    std::atomic<T> value;
+};
+
+
+//every thread gets a fixed index on first use, handed out round robin, so threads spread evenly over shards
+inline size_t this_thread_shard(size_t shards){
+    static std::atomic<size_t> next_index{0};
+    thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index % shards;
+}
+
+//size of a cache line, shards live on separate lines so updates from different cores do not contend
+constexpr inline size_t cache_line_size = 64;
+
+
+/*
+    accumulator split into `shards` atomics on separate cache lines. every thread adds to its own shard with a
+    relaxed fetch_add, so adds from different cores never touch the same line and throughput grows with the
+    core count. reading sums the shards, which costs `shards` loads and is meant to be rare.
+    the sum wraps on overflow exactly like a single atomic counter would.
+*/
+template<typename T, size_t fraction, size_t shards = 64>
+class sharded_fixed_accumulator{
+    static_assert(std::is_integral_v<T>, "sharded_fixed_accumulator needs a builtin integer type");
+    static_assert(shards > 0, "needs at least one shard");
+
+public:
+    using value_type = fixed<T, fraction>;
+
+    sharded_fixed_accumulator() = default;
+
+    sharded_fixed_accumulator(const sharded_fixed_accumulator&) = delete;
+    sharded_fixed_accumulator& operator=(const sharded_fixed_accumulator&) = delete;
+
+    void add(value_type x){
+        counters[this_thread_shard(shards)].value.fetch_add(x.v, std::memory_order_relaxed);
+    }
+
+    void sub(value_type x){
+        counters[this_thread_shard(shards)].value.fetch_sub(x.v, std::memory_order_relaxed);
+    }
+
+    value_type value() const{
+        using U = std::make_unsigned_t<T>;
+        U sum = 0;
+        for(const auto& shard : counters) sum += static_cast<U>(shard.value.load(std::memory_order_relaxed));
+        return fp_from_bits<T, fraction>(static_cast<T>(sum));
+    }
+
+    void reset(){
+        for(auto& shard : counters) shard.value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(cache_line_size) shard{
+        std::atomic<T> value{0};
+    };
+
+    std::array<shard, shards> counters{};
+};
+
+
+/*
+    histogram of fixed values with 2^bucket_bits buckets, keyed on the top bucket_bits bits of v.
+    for signed types the sign bit is flipped first, so the buckets are in the same order as the values and
+    bucket b holds [lower_bound(b), lower_bound(b + 1)).
+    counts are relaxed atomic increments, split over `shards` copies of the histogram like sharded_fixed_accumulator.
+*/
+template<typename T, size_t fraction, size_t bucket_bits, size_t shards = 8>
+class concurrent_histogram{
+    static_assert(std::is_integral_v<T>, "concurrent_histogram needs a builtin integer type");
+    static_assert(bucket_bits >= 1 and bucket_bits <= 20 and bucket_bits <= sizeof(T) * 8, "between 2 and 2^20 buckets");
+    static_assert(shards > 0, "needs at least one shard");
+
+    using U = std::make_unsigned_t<T>;
+    constexpr static size_t bits = sizeof(T) * 8;
+    constexpr static U sign_flip = std::is_signed_v<T> ? U(U(1) << (bits - 1)) : U(0);
+
+public:
+    using value_type = fixed<T, fraction>;
+
+    constexpr static size_t bucket_count = size_t{1} << bucket_bits;
+
+    concurrent_histogram() : rows(new shard_row[shards]){
+    }
+
+    static size_t bucket_of(value_type x){
+        return static_cast<size_t>(static_cast<U>(static_cast<U>(x.v) ^ sign_flip) >> (bits - bucket_bits));
+    }
+
+    //smallest value that falls into bucket b
+    static value_type lower_bound(size_t b){
+        assert(b < bucket_count);
+        U key = static_cast<U>(static_cast<U>(b) << (bits - bucket_bits));
+        return fp_from_bits<T, fraction>(static_cast<T>(key ^ sign_flip));
+    }
+
+    void add(value_type x){
+        rows[this_thread_shard(shards)].counts[bucket_of(x)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*
+        counts a whole span locally first, then publishes only the buckets that changed.
+        the local counts live in a per thread scratch buffer which is all zero between calls,
+        so a call costs one pass over the values and one atomic add per touched bucket.
+    */
+    void add(std::span<const value_type> values){
+        thread_local std::vector<uint32_t> local;
+        thread_local std::vector<uint32_t> touched;
+        if(local.size() < bucket_count) local.resize(bucket_count, 0);
+        auto& mine = rows[this_thread_shard(shards)].counts;
+        for(size_t start = 0; start < values.size(); start += max_local_run){
+            size_t end = std::min(values.size(), start + max_local_run);
+            touched.clear();
+            for(size_t i = start; i < end; i++){
+                size_t b = bucket_of(values[i]);
+                if(local[b]++ == 0) touched.push_back(static_cast<uint32_t>(b));
+            }
+            for(uint32_t b : touched){
+                mine[b].fetch_add(local[b], std::memory_order_relaxed);
+                local[b] = 0;
+            }
+        }
+    }
+
+    uint64_t count(size_t b) const{
+        assert(b < bucket_count);
+        uint64_t sum = 0;
+        for(size_t s = 0; s < shards; s++) sum += rows[s].counts[b].load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    uint64_t total() const{
+        uint64_t sum = 0;
+        for(size_t b = 0; b < bucket_count; b++) sum += count(b);
+        return sum;
+    }
+
+    std::vector<uint64_t> snapshot() const{
+        std::vector<uint64_t> result(bucket_count);
+        for(size_t b = 0; b < bucket_count; b++) result[b] = count(b);
+        return result;
+    }
+
+    void reset(){
+        for(size_t s = 0; s < shards; s++){
+            for(auto& c : rows[s].counts) c.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    //keeps the local 32 bit counts from overflowing
+    constexpr static size_t max_local_run = size_t{1} << 30;
+
+    //every shard starts on its own cache line
+    struct alignas(cache_line_size) shard_row{
+        std::array<std::atomic<uint64_t>, bucket_count> counts{};
+    };
+
+    std::unique_ptr<shard_row[]> rows;
+};
+
+}//namespace fixed_point
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <span>
+
+namespace fixed_point{
+
+template<typename T, size_t fraction>
+struct complex_fixed{
+    using value_type = fixed<T, fraction>;
+
+    value_type re;
+    value_type im;
+};
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> make_complex(fixed<T, fraction> re, fixed<T, fraction> im){
+    return {re, im};
+}
+
+template<typename T, size_t fraction>
+constexpr inline bool operator==(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    return a.re == b.re and a.im == b.im;
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator+(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    return {a.re + b.re, a.im + b.im};
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator-(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    return {a.re - b.re, a.im - b.im};
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator-(complex_fixed<T, fraction> a){
+    return {-a.re, -a.im};
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction>& operator+=(complex_fixed<T, fraction>& a, complex_fixed<T, fraction> b){
+    a = a + b;
+    return a;
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction>& operator-=(complex_fixed<T, fraction>& a, complex_fixed<T, fraction> b){
+    a = a - b;
+    return a;
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> conj(complex_fixed<T, fraction> a){
+    return {a.re, -a.im};
+}
+
+namespace detail{
+
+/*
+    p + q rounded to T, for two exact products of signed T components. the sum fits into the accumulator
+    except for min() * min() + min() * min(), which is one past its maximum. the addition wraps instead,
+    this single case is the only one landing on the accumulator's minimum and it saturates like every other result.
+*/
+template<typename T, typename A>
+constexpr inline T round_product_sum(A p, A q, size_t fraction){
+    A sum;
+    if constexpr(std::is_integral_v<A>){
+        using U = std::make_unsigned_t<A>;
+        sum = static_cast<A>(static_cast<U>(p) + static_cast<U>(q));
+    }
+    else sum = p + q;
+    if(sum == std::numeric_limits<A>::min()) return std::numeric_limits<T>::max();
+    return saturate<T>(rounding_shift_right(sum, fraction));
+}
+
+//p - q rounded to T, the difference of two products always fits into the accumulator
+template<typename T, typename A>
+constexpr inline T round_product_difference(A p, A q, size_t fraction){
+    return saturate<T>(rounding_shift_right(p - q, fraction));
+}
+
+}//namespace detail
+
+/*
+    fused complex product: both real products of each component are summed at full width
+    and rounded once, instead of four truncating fixed multiplies. results outside of T saturate.
+*/
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator*(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    static_assert(std::numeric_limits<T>::is_signed, "complex products need signed components");
+    using A = accumulator_t<T>;
+    return {fp_from_bits<T, fraction>(detail::round_product_difference<T>(static_cast<A>(a.re.v) * b.re.v, static_cast<A>(a.im.v) * b.im.v, fraction)),
+            fp_from_bits<T, fraction>(detail::round_product_sum<T>(static_cast<A>(a.re.v) * b.im.v, static_cast<A>(a.im.v) * b.re.v, fraction))};
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator*(complex_fixed<T, fraction> a, fixed<T, fraction> b){
+    using A = accumulator_t<T>;
+    return {fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(static_cast<A>(a.re.v) * b.v, fraction))),
+            fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(static_cast<A>(a.im.v) * b.v, fraction)))};
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> operator*(fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    return b * a;
+}
+
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction>& operator*=(complex_fixed<T, fraction>& a, complex_fixed<T, fraction> b){
+    a = a * b;
+    return a;
+}
+
+/*
+    gauss' three multiply complex product:
+        k1 = br (ar + ai), k2 = ar (bi - br), k3 = ai (br + bi)
+        re = k1 - k3, im = k1 + k2
+    trades one multiply for three additions. the sums need one extra bit, so for 32 bit types the
+    components must stay below 2^30 in magnitude for the products to fit into 64 bits.
+    rounds and saturates the same way as operator* and gives the same result whenever the sums fit.
+*/
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> multiply_gauss(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    using A = accumulator_t<T>;
+    A ar = a.re.v, ai = a.im.v, br = b.re.v, bi = b.im.v;
+    A k1 = br * (ar + ai);
+    A k2 = ar * (bi - br);
+    A k3 = ai * (br + bi);
+    return {fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(k1 - k3, fraction))),
+            fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(k1 + k2, fraction)))};
+}
+
+//a * conj(b) without negating b first
+template<typename T, size_t fraction>
+constexpr inline complex_fixed<T, fraction> conj_multiply(complex_fixed<T, fraction> a, complex_fixed<T, fraction> b){
+    static_assert(std::numeric_limits<T>::is_signed, "complex products need signed components");
+    using A = accumulator_t<T>;
+    return {fp_from_bits<T, fraction>(detail::round_product_sum<T>(static_cast<A>(a.re.v) * b.re.v, static_cast<A>(a.im.v) * b.im.v, fraction)),
+            fp_from_bits<T, fraction>(detail::round_product_difference<T>(static_cast<A>(a.im.v) * b.re.v, static_cast<A>(a.re.v) * b.im.v, fraction))};
+}
+
+/*
+    unsigned type for re^2 + im^2. with two min() components of a signed 32 bit type the sum is 2^63,
+    one more than int64_t holds, so it is unsigned. unsigned 32 bit components could need 65 bits, they are not supported.
+*/
+template<typename T>
+using magnitude_squared_t = std::conditional_t<sizeof(T) <= 4, uint64_t, wide_uint<128>>;
+
+//re^2 + im^2 with 2 * fraction fractional bits, can not overflow
+template<typename T, size_t fraction>
+constexpr inline magnitude_squared_t<T> wide_magnitude_squared(complex_fixed<T, fraction> a){
+    static_assert(std::is_signed_v<T> or sizeof(T) <= 2, "the magnitude of unsigned components of more than 16 bits may not fit");
+    using A = accumulator_t<T>;
+    using U = magnitude_squared_t<T>;
+    return U(static_cast<A>(a.re.v) * a.re.v) + U(static_cast<A>(a.im.v) * a.im.v);
+}
+
+//re^2 + im^2 rounded to the input format, saturates if it does not fit
+template<typename T, size_t fraction>
+constexpr inline fixed<T, fraction> magnitude_squared(complex_fixed<T, fraction> a){
+    return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(wide_magnitude_squared(a), fraction)));
+}
+
+
+/*
+    batch kernels. the interleaved versions work on arrays of complex_fixed,
+    the split versions on separate arrays of real and imaginary parts, which vectorize better.
+    out may alias a or b.
+*/
+template<typename T, size_t fraction>
+inline void complex_multiply(std::span<const complex_fixed<T, fraction>> a, std::span<const complex_fixed<T, fraction>> b,
+                             std::span<complex_fixed<T, fraction>> out){
+    assert(a.size() == b.size() and out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++) out[i] = a[i] * b[i];
+}
+
+template<typename T, size_t fraction>
+inline void complex_multiply_gauss(std::span<const complex_fixed<T, fraction>> a, std::span<const complex_fixed<T, fraction>> b,
+                                   std::span<complex_fixed<T, fraction>> out){
+    assert(a.size() == b.size() and out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++) out[i] = multiply_gauss(a[i], b[i]);
+}
+
+template<typename T, size_t fraction>
+inline void complex_conj_multiply(std::span<const complex_fixed<T, fraction>> a, std::span<const complex_fixed<T, fraction>> b,
+                                  std::span<complex_fixed<T, fraction>> out){
+    assert(a.size() == b.size() and out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++) out[i] = conj_multiply(a[i], b[i]);
+}
+
+template<typename T, size_t fraction>
+inline void complex_magnitude_squared(std::span<const complex_fixed<T, fraction>> a, std::span<fixed<T, fraction>> out){
+    assert(out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++) out[i] = magnitude_squared(a[i]);
+}
+
+template<typename T, size_t fraction>
+inline void complex_multiply_split(std::span<const fixed<T, fraction>> a_re, std::span<const fixed<T, fraction>> a_im,
+                                   std::span<const fixed<T, fraction>> b_re, std::span<const fixed<T, fraction>> b_im,
+                                   std::span<fixed<T, fraction>> out_re, std::span<fixed<T, fraction>> out_im){
+    assert(a_re.size() == a_im.size() and b_re.size() == a_re.size() and b_im.size() == a_re.size());
+    assert(out_re.size() >= a_re.size() and out_im.size() >= a_re.size());
+    static_assert(std::numeric_limits<T>::is_signed, "complex products need signed components");
+    using A = accumulator_t<T>;
+    for(size_t i = 0; i < a_re.size(); i++){
+        T re = detail::round_product_difference<T>(static_cast<A>(a_re[i].v) * b_re[i].v, static_cast<A>(a_im[i].v) * b_im[i].v, fraction);
+        T im = detail::round_product_sum<T>(static_cast<A>(a_re[i].v) * b_im[i].v, static_cast<A>(a_im[i].v) * b_re[i].v, fraction);
+        out_re[i].v = re;
+        out_im[i].v = im;
+    }
+}
+
+template<typename T, size_t fraction>
+inline void complex_conj_multiply_split(std::span<const fixed<T, fraction>> a_re, std::span<const fixed<T, fraction>> a_im,
+                                        std::span<const fixed<T, fraction>> b_re, std::span<const fixed<T, fraction>> b_im,
+                                        std::span<fixed<T, fraction>> out_re, std::span<fixed<T, fraction>> out_im){
+    assert(a_re.size() == a_im.size() and b_re.size() == a_re.size() and b_im.size() == a_re.size());
+    assert(out_re.size() >= a_re.size() and out_im.size() >= a_re.size());
+    static_assert(std::numeric_limits<T>::is_signed, "complex products need signed components");
+    using A = accumulator_t<T>;
+    for(size_t i = 0; i < a_re.size(); i++){
+        T re = detail::round_product_sum<T>(static_cast<A>(a_re[i].v) * b_re[i].v, static_cast<A>(a_im[i].v) * b_im[i].v, fraction);
+        T im = detail::round_product_difference<T>(static_cast<A>(a_im[i].v) * b_re[i].v, static_cast<A>(a_re[i].v) * b_im[i].v, fraction);
+        out_re[i].v = re;
+        out_im[i].v = im;
+    }
+}
+
+template<typename T, size_t fraction>
+inline void complex_magnitude_squared_split(std::span<const fixed<T, fraction>> re, std::span<const fixed<T, fraction>> im,
+                                            std::span<fixed<T, fraction>> out){
+    assert(re.size() == im.size() and out.size() >= re.size());
+    using A = accumulator_t<T>;
+    using U = magnitude_squared_t<T>;
+    for(size_t i = 0; i < re.size(); i++){
+        U m = U(static_cast<A>(re[i].v) * re[i].v) + U(static_cast<A>(im[i].v) * im[i].v);
+        out[i].v = saturate<T>(rounding_shift_right(m, fraction));
+    }
+}
+
+}//namespace fixed_point
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <span>
+
+namespace fixed_point{
+
+enum class rounding_mode{
+    truncate,   //drop the extra fractional bits, i.e. round towards negative infinity like the explicit conversion
+    nearest     //round to nearest, ties towards positive infinity
+};
+
+enum class overflow_mode{
+    wrap,       //keep the low bits like static_cast
+    saturate    //clamp to the range of the target type
+};
+
+/*
+    converts between any two fixed formats of at most 32 bits.
+    the value is moved to the new fraction in a 64 bit intermediate, which can not overflow,
+    and then narrowed to the target type according to the overflow mode.
+*/
+template<typename T, size_t fraction, rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate,
+         typename S, size_t source_fraction>
+constexpr inline fixed<T, fraction> fixed_cast(fixed<S, source_fraction> x){
+    static_assert(sizeof(S) <= 4 and sizeof(T) <= 4, "conversion of 64 bit fixed point numbers is not implemented, sorry");
+    int64_t v = x.v;
+    if constexpr(fraction < source_fraction){
+        constexpr size_t shift = source_fraction - fraction;
+        if constexpr(rounding == rounding_mode::nearest){
+            v = rounding_shift_right(v, shift);
+        }
+        else{
+            v >>= shift;
+        }
+    }
+    else if constexpr(fraction > source_fraction){
+        constexpr size_t shift = fraction - source_fraction;
+        if constexpr(overflow == overflow_mode::saturate){
+            //clamp before shifting, a 32 bit value shifted by up to 32 bits might not fit into 64
+            constexpr int64_t lo = static_cast<int64_t>(std::numeric_limits<T>::min()) >> shift;
+            constexpr int64_t hi = static_cast<int64_t>(std::numeric_limits<T>::max()) >> shift;
+            v = std::clamp(v, lo - 1, hi + 1);
+        }
+        v = static_cast<int64_t>(static_cast<uint64_t>(v) << shift);
+    }
+    if constexpr(overflow == overflow_mode::saturate){
+        return fp_from_bits<T, fraction>(saturate<T>(v));
+    }
+    else{
+        return fp_from_bits<T, fraction>(static_cast<T>(v));
+    }
+}
+
+/*
+    out[i] = fixed_cast(in[i]). the loop is branch free, so the compiler vectorizes it and
+    narrowing with saturation becomes packssdw / packsswb style packs, widening becomes pmovsx / pmovzx.
+*/
+template<typename T, size_t fraction, rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate,
+         typename S, size_t source_fraction>
+inline void convert(std::span<const fixed<S, source_fraction>> in, std::span<fixed<T, fraction>> out){
+    assert(out.size() >= in.size());
+    for(size_t i = 0; i < in.size(); i++){
+        out[i] = fixed_cast<T, fraction, rounding, overflow>(in[i]);
+    }
+}
+
+}//namespace fixed_point
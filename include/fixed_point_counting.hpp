@@ -0,0 +1,389 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_float_conversions.hpp"
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <fmt/core.h>
+
+namespace fixed_point{
+
+//operations counted by counting_fixed, add also covers subtraction, negation and abs
+enum class fixed_op{add, multiply, divide, fast_divide, sqrt_iteration, compare, convert, float_conversion};
+
+constexpr inline size_t fixed_op_count = 8;
+
+inline constexpr std::string_view fixed_op_name(fixed_op op){
+    switch(op){
+        case fixed_op::add:              return "add";
+        case fixed_op::multiply:         return "multiply";
+        case fixed_op::divide:           return "divide";
+        case fixed_op::fast_divide:      return "fast divide";
+        case fixed_op::sqrt_iteration:   return "sqrt iteration";
+        case fixed_op::compare:          return "compare";
+        case fixed_op::convert:          return "convert";
+        default:                         return "float conversion";
+    }
+}
+
+/*
+    cycles per operation on a target, indexed by fixed_op.
+    divide is correctly_rounded_division, fast_divide is operator/ and fast_division, both are one hardware
+    (or library) division of the doubled width. sqrt_iteration is the overhead of one newton step of sqrt
+    beyond the division it contains, which is counted separately.
+    the presets are rough latencies for 32 bit int types, measure your own target for accurate numbers.
+*/
+using cycle_table = std::array<double, fixed_op_count>;
+
+//64 bit divide in hardware, double conversion and rounding in sse
+constexpr inline cycle_table x86_64_cycles = {1, 4, 45, 40, 2, 1, 1, 10};
+
+//32x32 -> 64 bit multiply in one cycle, but 64 / 32 bit division is a library call, single precision fpu
+constexpr inline cycle_table cortex_m4_cycles = {1, 2, 110, 100, 3, 1, 1, 20};
+
+//no long multiply and no divide instruction, no fpu
+constexpr inline cycle_table cortex_m0_cycles = {1, 25, 450, 420, 4, 2, 2, 150};
+
+
+struct op_counts{
+    std::array<uint64_t, fixed_op_count> counts{};
+
+    void record(fixed_op op, uint64_t n = 1){
+        counts[static_cast<size_t>(op)] += n;
+    }
+
+    uint64_t operator[](fixed_op op) const{
+        return counts[static_cast<size_t>(op)];
+    }
+
+    uint64_t total() const{
+        uint64_t sum = 0;
+        for(auto c : counts) sum += c;
+        return sum;
+    }
+
+    double cycles(const cycle_table& table) const{
+        double sum = 0.0;
+        for(size_t i = 0; i < fixed_op_count; i++) sum += static_cast<double>(counts[i]) * table[i];
+        return sum;
+    }
+
+    double division_cycles(const cycle_table& table) const{
+        return static_cast<double>((*this)[fixed_op::divide]) * table[static_cast<size_t>(fixed_op::divide)] +
+               static_cast<double>((*this)[fixed_op::fast_divide]) * table[static_cast<size_t>(fixed_op::fast_divide)];
+    }
+
+    op_counts& operator+=(const op_counts& other){
+        for(size_t i = 0; i < fixed_op_count; i++) counts[i] += other.counts[i];
+        return *this;
+    }
+};
+
+//note: not thread safe, count a single threaded representative run
+class op_counter{
+    std::map<std::string, op_counts, std::less<>> records;
+
+public:
+    op_counts& kernel(std::string_view name){
+        auto it = records.find(name);
+        if(it == records.end()) it = records.emplace(std::string(name), op_counts{}).first;
+        return it->second;
+    }
+
+    const std::map<std::string, op_counts, std::less<>>& kernels() const{
+        return records;
+    }
+
+    void clear(){
+        records.clear();
+    }
+
+    //prints the counts and estimated cycles of every kernel and warns when divisions dominate the estimate
+    void report(const cycle_table& table = x86_64_cycles, double division_warning = 0.25) const{
+        for(const auto& [name, c] : records){
+            double total = c.cycles(table);
+            fmt::print("{}: {} operations, estimated {:.0f} cycles\n", name, c.total(), total);
+            for(size_t i = 0; i < fixed_op_count; i++){
+                if(c.counts[i] == 0) continue;
+                fmt::print("    {}: {} x {} = {:.0f} cycles\n", fixed_op_name(static_cast<fixed_op>(i)), c.counts[i],
+                           table[i], static_cast<double>(c.counts[i]) * table[i]);
+            }
+            double share = total > 0.0 ? c.division_cycles(table) / total : 0.0;
+            if(share >= division_warning){
+                fmt::print("    warning: divisions are {:.0f}% of the estimated cycles\n", 100.0 * share);
+            }
+        }
+    }
+};
+
+inline op_counter& default_op_counter(){
+    static op_counter counter;
+    return counter;
+}
+
+namespace detail{
+
+inline op_counts*& active_op_counts(){
+    thread_local op_counts* active = nullptr;
+    return active;
+}
+
+inline void record_op(fixed_op op, uint64_t n = 1){
+    if(auto* counts = active_op_counts()) counts->record(op, n);
+}
+
+}//namespace detail
+
+//operations of counting_fixed values in this thread are recorded for `kernel` while the scope lives, scopes nest
+class counting_scope{
+public:
+    counting_scope(std::string_view kernel, op_counter& counter = default_op_counter())
+        : previous(detail::active_op_counts()){
+        detail::active_op_counts() = &counter.kernel(kernel);
+    }
+
+    ~counting_scope(){
+        detail::active_op_counts() = previous;
+    }
+
+    counting_scope(const counting_scope&) = delete;
+    counting_scope& operator=(const counting_scope&) = delete;
+
+private:
+    op_counts* previous;
+};
+
+
+/*
+    drop in replacement for fixed<T, fraction> which computes exactly like fixed, so a kernel gives
+    bit identical results, and records every operation to the active counting_scope.
+*/
+template<typename T, size_t fraction>
+struct counting_fixed{
+    using int_type = T;
+    using fixed_type = fixed<T, fraction>;
+
+    fixed_type f;
+
+    constexpr counting_fixed() = default;
+
+    constexpr counting_fixed(const counting_fixed& other) = default;
+
+    constexpr counting_fixed& operator=(const counting_fixed& other) = default;
+
+    constexpr counting_fixed(int_type i) : f(i){
+    }
+
+    template<size_t S>
+    constexpr counting_fixed(fixed_construction_helper<S> helper) : f(helper){
+    }
+
+    constexpr counting_fixed(fixed_type x) : f(x){
+    }
+
+    counting_fixed& operator=(int i){
+        f = i;
+        return *this;
+    }
+
+    fixed_type to_fixed() const{
+        return f;
+    }
+
+    template<typename S, size_t new_frac_bits>
+    explicit operator counting_fixed<S, new_frac_bits>() const{
+        detail::record_op(fixed_op::convert);
+        return counting_fixed<S, new_frac_bits>(static_cast<fixed<S, new_frac_bits>>(f));
+    }
+
+    constexpr static size_t frac_bits(){
+        return fixed_type::frac_bits();
+    }
+
+    constexpr static size_t whole_bits(){
+        return fixed_type::whole_bits();
+    }
+
+    constexpr static bool is_signed(){
+        return fixed_type::is_signed();
+    }
+
+    int_type to_int() const{
+        detail::record_op(fixed_op::convert);
+        return fixed_type(f).to_int();
+    }
+
+    int_type whole_part() const{
+        return fixed_type(f).whole_part();
+    }
+
+    int_type frac_part() const{
+        return fixed_type(f).frac_part();
+    }
+
+    std::array<char, fixed_type::string_size()> to_string() const{
+        return f.to_string();
+    }
+};
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> counting_from_float(float x){
+    detail::record_op(fixed_op::float_conversion);
+    return counting_fixed<T, fraction>(fp_from_float<T, fraction>(x));
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> operator+(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::add);
+    return a.f + b.f;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator+(counting_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a + counting_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator+(fixed_construction_helper<S> a, counting_fixed<T, fraction> b){
+    return counting_fixed<T, fraction>(a) + b;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> operator-(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::add);
+    return a.f - b.f;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator-(counting_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a - counting_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator-(fixed_construction_helper<S> a, counting_fixed<T, fraction> b){
+    return counting_fixed<T, fraction>(a) - b;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> operator-(counting_fixed<T, fraction> a){
+    detail::record_op(fixed_op::add);
+    return -a.f;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> operator*(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::multiply);
+    return a.f * b.f;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator*(counting_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a * counting_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator*(fixed_construction_helper<S> a, counting_fixed<T, fraction> b){
+    return counting_fixed<T, fraction>(a) * b;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> operator/(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::fast_divide);
+    return a.f / b.f;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator/(counting_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a / counting_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline counting_fixed<T, fraction> operator/(fixed_construction_helper<S> a, counting_fixed<T, fraction> b){
+    return counting_fixed<T, fraction>(a) / b;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> correctly_rounded_division(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::divide);
+    return correctly_rounded_division(a.f, b.f);
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> fast_division(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::fast_divide);
+    return fast_division(a.f, b.f);
+}
+
+template<typename T, size_t fraction, typename U>
+inline counting_fixed<T, fraction>& operator+=(counting_fixed<T, fraction>& a, U b){
+    a = a + b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline counting_fixed<T, fraction>& operator-=(counting_fixed<T, fraction>& a, U b){
+    a = a - b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline counting_fixed<T, fraction>& operator*=(counting_fixed<T, fraction>& a, U b){
+    a = a * b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline counting_fixed<T, fraction>& operator/=(counting_fixed<T, fraction>& a, U b){
+    a = a / b;
+    return a;
+}
+
+/*
+    fixed's sqrt runs 4 newton steps with operator/ and a final step with two correctly rounded divisions,
+    they are recorded as such so the divisions show up in the estimate.
+*/
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> sqrt(counting_fixed<T, fraction> x){
+    detail::record_op(fixed_op::sqrt_iteration, 5);
+    detail::record_op(fixed_op::fast_divide, 4);
+    detail::record_op(fixed_op::divide, 2);
+    return sqrt(x.f);
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> abs(counting_fixed<T, fraction> a){
+    detail::record_op(fixed_op::add);
+    return a.f.v < 0 ? -a.f : a.f;
+}
+
+template<typename T, size_t fraction>
+inline counting_fixed<T, fraction> clamp(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b, counting_fixed<T, fraction> c){
+    detail::record_op(fixed_op::compare, 2);
+    return clamp(a.f, b.f, c.f);
+}
+
+template<typename T, size_t fraction>
+inline bool operator==(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::compare);
+    return a.f.v == b.f.v;
+}
+
+template<typename T, size_t fraction>
+inline std::strong_ordering operator<=>(counting_fixed<T, fraction> a, counting_fixed<T, fraction> b){
+    detail::record_op(fixed_op::compare);
+    return a.f.v <=> b.f.v;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline std::strong_ordering operator<=>(counting_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a <=> counting_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline std::strong_ordering operator<=>(fixed_construction_helper<S> a, counting_fixed<T, fraction> b){
+    return counting_fixed<T, fraction>(a) <=> b;
+}
+
+}//namespace fixed_point
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "fixed_point_convert.hpp"
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fixed_point{
+
+//format of a fixed value only known at runtime, e.g. read from a file or a message
+struct fixed_format{
+    uint8_t width;      //bytes, 1, 2 or 4
+    bool is_signed;
+    uint8_t fraction;   //0 to 8 * width - 1, unsigned formats may use all 8 * width bits
+
+    constexpr bool operator==(const fixed_format&) const = default;
+
+    constexpr bool valid() const{
+        return (width == 1 or width == 2 or width == 4) and fraction <= 8 * width - (is_signed ? 1 : 0);
+    }
+};
+
+template<typename T, size_t fraction>
+constexpr inline fixed_format format_of(){
+    return {static_cast<uint8_t>(sizeof(T)), std::is_signed_v<T>, static_cast<uint8_t>(fraction)};
+}
+
+/*
+    every valid format has an index into a table of pre-instantiated kernels:
+    9 + 17 + 33 unsigned fractions for the 3 widths, then 8 + 16 + 32 signed ones.
+*/
+constexpr inline size_t unsigned_format_count = 9 + 17 + 33;
+constexpr inline size_t format_count = unsigned_format_count + 8 + 16 + 32;
+
+constexpr inline size_t format_index(fixed_format format){
+    assert(format.valid());
+    if(format.is_signed){
+        size_t base = format.width == 1 ? 0 : format.width == 2 ? 8 : 24;
+        return unsigned_format_count + base + format.fraction;
+    }
+    size_t base = format.width == 1 ? 0 : format.width == 2 ? 9 : 26;
+    return base + format.fraction;
+}
+
+constexpr inline fixed_format format_from_index(size_t index){
+    if(index >= unsigned_format_count){
+        index -= unsigned_format_count;
+        if(index < 8) return {1, true, static_cast<uint8_t>(index)};
+        if(index < 24) return {2, true, static_cast<uint8_t>(index - 8)};
+        return {4, true, static_cast<uint8_t>(index - 24)};
+    }
+    if(index < 9) return {1, false, static_cast<uint8_t>(index)};
+    if(index < 26) return {2, false, static_cast<uint8_t>(index - 9)};
+    return {4, false, static_cast<uint8_t>(index - 26)};
+}
+
+template<size_t width, bool is_signed>
+using format_int_t = std::conditional_t<width == 1, std::conditional_t<is_signed, int8_t, uint8_t>,
+                     std::conditional_t<width == 2, std::conditional_t<is_signed, int16_t, uint16_t>,
+                                                    std::conditional_t<is_signed, int32_t, uint32_t>>>;
+
+template<size_t index>
+struct format_fixed{
+    constexpr static fixed_format format = format_from_index(index);
+    using type = fixed<format_int_t<format.width, format.is_signed>, format.fraction>;
+};
+
+template<size_t index>
+using format_fixed_t = typename format_fixed<index>::type;
+
+
+namespace detail{
+
+template<typename R, typename F, size_t index>
+R invoke_with_format(F& f){
+    return f(format_fixed_t<index>{});
+}
+
+template<typename R, typename F, size_t... indices>
+constexpr auto make_format_table(std::index_sequence<indices...>){
+    return std::array<R(*)(F&), sizeof...(indices)>{&invoke_with_format<R, F, indices>...};
+}
+
+}//namespace detail
+
+/*
+    calls f(fixed<T, fraction>{}) with the compile time type matching format.
+    the call goes through a table of function pointers, so a generic lambda is instantiated once for
+    every format and the runtime cost is one indirect call. all instantiations must return the same type.
+*/
+template<typename F>
+inline decltype(auto) dispatch_format(fixed_format format, F&& f){
+    using R = decltype(f(fixed<int8_t, 0>{}));
+    constexpr static auto table = detail::make_format_table<R, F>(std::make_index_sequence<format_count>{});
+    return table[format_index(format)](f);
+}
+
+
+//a single value together with its format
+struct dynamic_fixed{
+    fixed_format format;
+    int64_t bits;
+
+    template<typename T, size_t fraction>
+    constexpr static dynamic_fixed from(fixed<T, fraction> x){
+        return {format_of<T, fraction>(), x.v};
+    }
+
+    template<typename T, size_t fraction, rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate>
+    fixed<T, fraction> to() const{
+        return dispatch_format(format, [this](auto tag){
+            using source = decltype(tag);
+            return fixed_cast<T, fraction, rounding, overflow>(fp_from_bits<typename source::int_type, source::frac_bits()>(
+                static_cast<typename source::int_type>(bits)));
+        });
+    }
+
+    double to_double() const{
+        return static_cast<double>(bits) / static_cast<double>(uint64_t{1} << format.fraction);
+    }
+};
+
+
+/*
+    array of fixed values whose format is chosen at runtime.
+    visit() hands the whole array to a kernel instantiated for the actual format,
+    so a loop over a runtime described column runs at the speed of the hardcoded template.
+*/
+class dynamic_fixed_array{
+public:
+    dynamic_fixed_array() = default;
+
+    dynamic_fixed_array(fixed_format format, size_t count) : fmt(format), count(count){
+        assert(format.valid());
+        storage.resize(count * format.width);
+    }
+
+    fixed_format format() const{
+        return fmt;
+    }
+
+    size_t size() const{
+        return count;
+    }
+
+    const std::byte* data() const{
+        return storage.data();
+    }
+
+    std::byte* data(){
+        return storage.data();
+    }
+
+    //calls f(std::span<fixed<T, fraction>>) for the format of the array
+    template<typename F>
+    decltype(auto) visit(F&& f){
+        return dispatch_format(fmt, [this, &f](auto tag){
+            using fixed_t = decltype(tag);
+            return f(std::span<fixed_t>(reinterpret_cast<fixed_t*>(storage.data()), count));
+        });
+    }
+
+    template<typename F>
+    decltype(auto) visit(F&& f) const{
+        return dispatch_format(fmt, [this, &f](auto tag){
+            using fixed_t = decltype(tag);
+            return f(std::span<const fixed_t>(reinterpret_cast<const fixed_t*>(storage.data()), count));
+        });
+    }
+
+    //typed access without dispatch, nullopt unless the array holds exactly fixed<T, fraction>
+    template<typename T, size_t fraction>
+    std::optional<std::span<fixed<T, fraction>>> view(){
+        if(fmt != format_of<T, fraction>()) return std::nullopt;
+        return std::span<fixed<T, fraction>>(reinterpret_cast<fixed<T, fraction>*>(storage.data()), count);
+    }
+
+    template<typename T, size_t fraction>
+    std::optional<std::span<const fixed<T, fraction>>> view() const{
+        if(fmt != format_of<T, fraction>()) return std::nullopt;
+        return std::span<const fixed<T, fraction>>(reinterpret_cast<const fixed<T, fraction>*>(storage.data()), count);
+    }
+
+    dynamic_fixed get(size_t i) const{
+        assert(i < count);
+        return visit([i, this](auto values){
+            return dynamic_fixed{fmt, static_cast<int64_t>(values[i].v)};
+        });
+    }
+
+    template<rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate>
+    void set(size_t i, dynamic_fixed x){
+        assert(i < count);
+        visit([i, x](auto values){
+            using fixed_t = typename decltype(values)::value_type;
+            values[i] = x.to<typename fixed_t::int_type, fixed_t::frac_bits(), rounding, overflow>();
+        });
+    }
+
+    //converts all values to fixed<T, fraction>, one dispatch for the whole array
+    template<typename T, size_t fraction, rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate>
+    void convert_to(std::span<fixed<T, fraction>> out) const{
+        assert(out.size() >= count);
+        visit([out](auto values){
+            convert<T, fraction, rounding, overflow>(values, out);
+        });
+    }
+
+    //replaces all values by in converted to the format of the array
+    template<rounding_mode rounding = rounding_mode::nearest, overflow_mode overflow = overflow_mode::saturate, typename S, size_t source_fraction>
+    void assign(std::span<const fixed<S, source_fraction>> in){
+        assert(in.size() == count);
+        visit([in](auto values){
+            using fixed_t = typename decltype(values)::value_type;
+            convert<typename fixed_t::int_type, fixed_t::frac_bits(), rounding, overflow>(in, values);
+        });
+    }
+
+private:
+    fixed_format fmt{4, true, 16};
+    size_t count = 0;
+    //allocated with operator new, so aligned for every supported width
+    std::vector<std::byte> storage;
+};
+
+}//namespace fixed_point
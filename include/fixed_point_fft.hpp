@@ -0,0 +1,197 @@
+#pragma once
+
+#include "fixed_point_complex.hpp"
+#include <array>
+#include <bit>
+#include <span>
+#include <utility>
+
+namespace fixed_point{
+
+//taylor series of sin(x), accurate to double precision for |x| <= pi/2
+constexpr inline double constexpr_sin(double x){
+    double result = 0.0;
+    double term = x;
+    for(int i = 1; i < 28; i += 2){
+        result += term;
+        term = -term * x * x / ((i + 1) * (i + 2));
+    }
+    return result;
+}
+
+/*
+    in place fft of N complex values with block floating point scaling.
+    before every pass the whole block is shifted right just enough that the pass can not overflow,
+    the shifts are summed up and returned, so the true transform is data * 2^exponent.
+
+    the transform is decimation in time on bit reversed input. pairs of radix 2 stages are fused
+    into one radix 4 pass which needs 3 twiddle multiplies per 4 points instead of 4, a single
+    radix 2 pass comes first if log2(N) is odd.
+    twiddles W^k = e^(-2 pi i k / N) are a compile time table in Q(bits - 1), 1.0 saturates to the maximum.
+*/
+template<typename T, size_t fraction, size_t N>
+class fixed_fft{
+    static_assert(std::is_signed_v<T> and sizeof(T) <= 4, "fft needs a signed type of at most 32 bits");
+    static_assert(std::has_single_bit(N) and N >= 4 and N <= 65536, "fft size must be a power of two between 4 and 65536");
+
+    using P = product_t<T>;
+    constexpr static int bits = static_cast<int>(sizeof(T) * 8);
+    constexpr static int twiddle_bits = bits - 1;
+
+    struct twiddle{
+        T re;
+        T im;
+    };
+
+    //radix 4 passes need W^j, W^2j and W^3j of their stage, which reach up to 3N/4.
+    //only a quarter wave of sines is evaluated, the rest follows from symmetry
+    constexpr static std::array<twiddle, 3 * N / 4> make_twiddles(){
+        constexpr size_t quarter_n = N / 4;
+        constexpr double half_pi = 1.57079632679489661923;
+        std::array<double, quarter_n + 1> quarter{};
+        for(size_t k = 0; k <= quarter_n; k++){
+            quarter[k] = constexpr_sin(half_pi * static_cast<double>(k) / static_cast<double>(quarter_n));
+        }
+
+        constexpr double one = static_cast<double>(P{1} << twiddle_bits);
+        constexpr double max = static_cast<double>(std::numeric_limits<T>::max());
+        auto to_q = [](double d){
+            double scaled = d * one;
+            scaled = scaled >= 0 ? scaled + 0.5 : scaled - 0.5;
+            if(scaled > max) scaled = max;
+            return static_cast<T>(scaled);
+        };
+
+        std::array<twiddle, 3 * N / 4> result{};
+        for(size_t k = 0; k < result.size(); k++){
+            size_t r = k % quarter_n;
+            double c = 0.0;
+            double s = 0.0;
+            switch(k / quarter_n){
+                case 0:  c =  quarter[quarter_n - r]; s =  quarter[r]; break;
+                case 1:  c = -quarter[r]; s =  quarter[quarter_n - r]; break;
+                default: c = -quarter[quarter_n - r]; s = -quarter[r]; break;
+            }
+            result[k] = {to_q(c), to_q(-s)};
+        }
+        return result;
+    }
+
+    constexpr static std::array<twiddle, 3 * N / 4> twiddles = make_twiddles();
+
+public:
+    using value_type = complex_fixed<T, fraction>;
+
+    //returns the exponent of the result, the spectrum is data * 2^exponent
+    static int forward(std::span<value_type, N> data){
+        return transform<false>(data);
+    }
+
+    //unnormalized inverse, the signal is data * 2^(exponent - log2(N))
+    static int inverse(std::span<value_type, N> data){
+        return transform<true>(data);
+    }
+
+private:
+    struct wide{
+        P re;
+        P im;
+    };
+
+    static void bit_reverse(std::span<value_type, N> data){
+        for(size_t i = 1, j = 0; i < N; i++){
+            size_t bit = N >> 1;
+            for(; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if(i < j) std::swap(data[i], data[j]);
+        }
+    }
+
+    static P magnitude(P x){
+        return x < 0 ? -x : x;
+    }
+
+    //shift so that peak * 2^-shift < 2^(bits - 1 - growth_bits)
+    static int headroom_shift(P peak, int growth_bits){
+        int used = std::bit_width(static_cast<std::make_unsigned_t<P>>(peak));
+        return std::max(0, used - (bits - 1 - growth_bits));
+    }
+
+    //rounds down, rounding to nearest could carry a value up to the bound of headroom_shift and overflow the pass
+    static wide load(const value_type& x, int shift){
+        return {static_cast<P>(x.re.v) >> shift, static_cast<P>(x.im.v) >> shift};
+    }
+
+    static void store(value_type& x, wide w, P& peak){
+        x.re.v = static_cast<T>(w.re);
+        x.im.v = static_cast<T>(w.im);
+        peak = std::max(peak, std::max(magnitude(w.re), magnitude(w.im)));
+    }
+
+    template<bool conjugate>
+    static wide rotate(wide x, twiddle w){
+        P wr = w.re;
+        P wi = conjugate ? -static_cast<P>(w.im) : static_cast<P>(w.im);
+        return {rounding_shift_right(x.re * wr - x.im * wi, twiddle_bits),
+                rounding_shift_right(x.re * wi + x.im * wr, twiddle_bits)};
+    }
+
+    template<bool inverse>
+    static int transform(std::span<value_type, N> data){
+        bit_reverse(data);
+
+        P peak = 0;
+        for(const auto& x : data){
+            peak = std::max(peak, std::max(magnitude(x.re.v), magnitude(x.im.v)));
+        }
+
+        int exponent = 0;
+        size_t m = 2;
+        if constexpr(std::countr_zero(N) % 2 == 1){
+            //radix 2 butterflies grow by at most 2
+            int shift = headroom_shift(peak, 1);
+            exponent += shift;
+            peak = 0;
+            for(size_t g = 0; g < N; g += 2){
+                wide x0 = load(data[g], shift);
+                wide x1 = load(data[g + 1], shift);
+                store(data[g], {x0.re + x1.re, x0.im + x1.im}, peak);
+                store(data[g + 1], {x0.re - x1.re, x0.im - x1.im}, peak);
+            }
+            m = 4;
+        }
+
+        //each pass fuses the radix 2 stages of size m and 2m
+        for(; m < N; m *= 4){
+            //a component grows by at most 1 + 3 sqrt(2) < 8
+            int shift = headroom_shift(peak, 3);
+            exponent += shift;
+            peak = 0;
+            size_t h = m / 2;
+            size_t stride = N / (2 * m);
+            for(size_t g = 0; g < N; g += 2 * m){
+                for(size_t j = 0; j < h; j++){
+                    wide x0 = load(data[g + j], shift);
+                    wide t1 = rotate<inverse>(load(data[g + j + h], shift), twiddles[2 * j * stride]);
+                    wide t2 = rotate<inverse>(load(data[g + j + 2 * h], shift), twiddles[j * stride]);
+                    wide t3 = rotate<inverse>(load(data[g + j + 3 * h], shift), twiddles[3 * j * stride]);
+
+                    wide a0 = {x0.re + t1.re, x0.im + t1.im};
+                    wide a1 = {x0.re - t1.re, x0.im - t1.im};
+                    wide s = {t2.re + t3.re, t2.im + t3.im};
+                    wide d = {t2.re - t3.re, t2.im - t3.im};
+                    //d * -i for the forward transform, d * i for the inverse
+                    wide r = inverse ? wide{-d.im, d.re} : wide{d.im, -d.re};
+
+                    store(data[g + j], {a0.re + s.re, a0.im + s.im}, peak);
+                    store(data[g + j + h], {a1.re + r.re, a1.im + r.im}, peak);
+                    store(data[g + j + 2 * h], {a0.re - s.re, a0.im - s.im}, peak);
+                    store(data[g + j + 3 * h], {a1.re - r.re, a1.im - r.im}, peak);
+                }
+            }
+        }
+        return exponent;
+    }
+};
+
+}//namespace fixed_point
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "fixed_point_type.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fixed_point{
+
+/*
+    binary file holding one array of fixed values:
+        [header, 64 bytes][values, count * width bytes]
+    the values start at data_offset, which is a multiple of 64 so a mapped file can be viewed in place.
+    all header fields are stored in the byte order recorded in `endianness`, the writer uses the native one.
+*/
+struct fixed_file_header{
+    constexpr static std::array<char, 8> expected_magic = {'F', 'I', 'X', 'P', 'A', 'R', 'R', '\0'};
+    constexpr static uint16_t current_version = 1;
+    constexpr static uint64_t header_size = 64;
+
+    std::array<char, 8> magic;
+    uint16_t version;
+    uint8_t width;      //bytes per value
+    uint8_t is_signed;
+    uint8_t fraction;
+    uint8_t endianness; //0 little, 1 big
+    uint16_t reserved;
+    uint64_t count;
+    uint64_t data_offset;
+    std::array<uint8_t, 32> padding;
+};
+
+static_assert(sizeof(fixed_file_header) == fixed_file_header::header_size, "the header must be exactly 64 bytes");
+
+constexpr inline uint8_t native_endianness(){
+    return std::endian::native == std::endian::little ? 0 : 1;
+}
+
+template<typename T, size_t fraction>
+constexpr inline fixed_file_header make_file_header(uint64_t count){
+    fixed_file_header header{};
+    header.magic = fixed_file_header::expected_magic;
+    header.version = fixed_file_header::current_version;
+    header.width = sizeof(T);
+    header.is_signed = std::is_signed_v<T>;
+    header.fraction = fraction;
+    header.endianness = native_endianness();
+    header.count = count;
+    header.data_offset = fixed_file_header::header_size;
+    return header;
+}
+
+//true if the values described by header can be viewed as fixed<T, fraction> on this machine
+template<typename T, size_t fraction>
+constexpr inline bool header_matches(const fixed_file_header& header){
+    return header.width == sizeof(T) and header.is_signed == std::is_signed_v<T> and header.fraction == fraction
+       and header.endianness == native_endianness() and header.data_offset % alignof(fixed<T, fraction>) == 0;
+}
+
+
+/*
+    streams an array of fixed<T, fraction> to a file chunk by chunk, the total count is
+    only known at the end and written into the header by close().
+    all functions return false if an io error occurred.
+*/
+template<typename T, size_t fraction>
+class fixed_file_writer{
+public:
+    fixed_file_writer() = default;
+
+    fixed_file_writer(const fixed_file_writer&) = delete;
+    fixed_file_writer& operator=(const fixed_file_writer&) = delete;
+
+    ~fixed_file_writer(){
+        close();
+    }
+
+    bool open(const std::string& path){
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if(not file) return false;
+        count = 0;
+        auto header = make_file_header<T, fraction>(0);
+        return std::fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    bool write(std::span<const fixed<T, fraction>> chunk){
+        if(not file) return false;
+        if(chunk.empty()) return true;
+        if(std::fwrite(chunk.data(), sizeof(T), chunk.size(), file) != chunk.size()) return false;
+        count += chunk.size();
+        return true;
+    }
+
+    bool close(){
+        if(not file) return true;
+        auto header = make_file_header<T, fraction>(count);
+        bool ok = std::fseek(file, 0, SEEK_SET) == 0 and std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok &= std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+    uint64_t size() const{
+        return count;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    uint64_t count = 0;
+};
+
+
+/*
+    maps a file written by fixed_file_writer into memory. opening costs the same for any file size,
+    pages are only read when the view is accessed.
+*/
+class mapped_fixed_file{
+public:
+    mapped_fixed_file() = default;
+
+    mapped_fixed_file(const mapped_fixed_file&) = delete;
+    mapped_fixed_file& operator=(const mapped_fixed_file&) = delete;
+
+    mapped_fixed_file(mapped_fixed_file&& other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), mapped_size(std::exchange(other.mapped_size, 0)){
+    }
+
+    mapped_fixed_file& operator=(mapped_fixed_file&& other) noexcept{
+        if(this != &other){
+            close();
+            mapping = std::exchange(other.mapping, nullptr);
+            mapped_size = std::exchange(other.mapped_size, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_fixed_file(){
+        close();
+    }
+
+    //false if the file can not be mapped or is not a valid fixed array file
+    bool open(const std::string& path){
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat info;
+        if(::fstat(fd, &info) != 0 or static_cast<uint64_t>(info.st_size) < fixed_file_header::header_size){
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED) return false;
+        mapping = p;
+        mapped_size = static_cast<size_t>(info.st_size);
+        if(not valid()){
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close(){
+        if(mapping) ::munmap(mapping, mapped_size);
+        mapping = nullptr;
+        mapped_size = 0;
+    }
+
+    bool is_open() const{
+        return mapping != nullptr;
+    }
+
+    fixed_file_header header() const{
+        assert(is_open());
+        fixed_file_header result;
+        std::memcpy(&result, mapping, sizeof(result));
+        //a file from a machine with the other byte order still has a readable header
+        if(result.endianness != native_endianness()){
+            result.version = byte_swap(result.version);
+            result.count = byte_swap(result.count);
+            result.data_offset = byte_swap(result.data_offset);
+        }
+        return result;
+    }
+
+    //the values without a copy, or nullopt if the file holds a different format than fixed<T, fraction>
+    template<typename T, size_t fraction>
+    std::optional<std::span<const fixed<T, fraction>>> view() const{
+        if(not is_open()) return std::nullopt;
+        auto h = header();
+        if(not header_matches<T, fraction>(h)) return std::nullopt;
+        auto first = reinterpret_cast<const fixed<T, fraction>*>(static_cast<const char*>(mapping) + h.data_offset);
+        return std::span<const fixed<T, fraction>>(first, h.count);
+    }
+
+private:
+    template<typename U>
+    static U byte_swap(U x){
+        U result = 0;
+        for(size_t i = 0; i < sizeof(U); i++){
+            result = static_cast<U>((result << 8) | (x & 0xff));
+            x >>= 8;
+        }
+        return result;
+    }
+
+    bool valid() const{
+        auto h = header();
+        if(h.magic != fixed_file_header::expected_magic or h.version != fixed_file_header::current_version) return false;
+        if(h.width == 0 or h.data_offset < fixed_file_header::header_size or h.data_offset > mapped_size) return false;
+        return h.count <= (mapped_size - h.data_offset) / h.width;
+    }
+
+    void* mapping = nullptr;
+    size_t mapped_size = 0;
+};
+
+}//namespace fixed_point
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <array>
+#include <span>
+
+namespace fixed_point{
+
+//sum of products over contiguous arrays, this is the loop the compiler turns into pmaddwd for 16 bit types
+template<typename A, typename T>
+inline A fir_dot(const T* h, const T* x, size_t n){
+    A acc = 0;
+    for(size_t i = 0; i < n; i++){
+        acc += static_cast<A>(h[i]) * static_cast<A>(x[i]);
+    }
+    return acc;
+}
+
+/*
+    accumulator which holds the sum of any number of taps of practical length: 64 bits for up to 16 bit samples,
+    twice the product width for wider samples, where accumulator_t<T> is only as wide as a single product.
+*/
+template<typename T>
+using fir_accumulator_t = std::conditional_t<sizeof(T) <= 2, accumulator_t<T>, wide_int<32 * sizeof(T), std::is_signed_v<T>>>;
+
+/*
+    finite impulse response filter with `taps` coefficients of coeff_fraction fractional bits.
+    the products of every tap are accumulated in A and rounded and saturated once per output sample.
+    the default accumulator is product_t<T>, i.e. 32 bits for 16 bit samples. That is what pmaddwd
+    accumulates into, but it requires sum(|h|) * max(|x|) to fit, pass fir_accumulator_t<T> for headroom.
+
+    the last `taps` input samples live in a doubled ring buffer so every window is contiguous,
+    process() over a span copies them in front of the block once and filters the whole block from a linear buffer.
+*/
+template<typename T, size_t fraction, size_t coeff_fraction, size_t taps, typename A = product_t<T>, size_t block_size = 256>
+class fir_filter{
+    static_assert(taps > 0, "a filter needs at least one tap");
+
+public:
+    using sample_type = fixed<T, fraction>;
+    using coeff_type = fixed<T, coeff_fraction>;
+
+    constexpr fir_filter() = default;
+
+    constexpr explicit fir_filter(const std::array<coeff_type, taps>& coefficients){
+        set_coefficients(coefficients);
+    }
+
+    constexpr void set_coefficients(std::span<const coeff_type, taps> coefficients){
+        //stored reversed so that h[k] * x[n - taps + 1 + k] walks both arrays forward
+        for(size_t k = 0; k < taps; k++) h[k] = coefficients[taps - 1 - k].v;
+    }
+
+    constexpr coeff_type coefficient(size_t k) const{
+        return fp_from_bits<T, coeff_fraction>(h[taps - 1 - k]);
+    }
+
+    constexpr void reset(){
+        ring.fill(0);
+        pos = 0;
+    }
+
+    constexpr sample_type process(sample_type x){
+        //ring[pos + taps - 1] is the newest sample, ring[pos] the oldest still needed
+        pos = pos + 1 == taps ? 0 : pos + 1;
+        size_t newest = pos == 0 ? taps - 1 : pos - 1;
+        ring[newest] = x.v;
+        ring[newest + taps] = x.v;
+        return output(fir_dot<A>(h.data(), &ring[pos], taps));
+    }
+
+    void process(std::span<const sample_type> in, std::span<sample_type> out){
+        assert(out.size() >= in.size());
+        for(size_t i = 0; i < taps - 1; i++) line[i] = ring[pos + 1 + i];
+
+        for(size_t start = 0; start < in.size(); start += block_size){
+            size_t n = std::min(block_size, in.size() - start);
+            for(size_t i = 0; i < n; i++) line[taps - 1 + i] = in[start + i].v;
+            for(size_t i = 0; i < n; i++){
+                out[start + i] = output(fir_dot<A>(h.data(), &line[i], taps));
+            }
+            for(size_t i = 0; i < taps - 1; i++) line[i] = line[n + i];
+        }
+
+        //put the history back in the ring, oldest sample first
+        pos = 0;
+        for(size_t i = 0; i < taps - 1; i++){
+            ring[1 + i] = line[i];
+            ring[1 + i + taps] = line[i];
+        }
+    }
+
+private:
+    constexpr sample_type output(A acc) const{
+        return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, coeff_fraction)));
+    }
+
+    std::array<T, taps> h{};
+    std::array<T, 2 * taps> ring{};
+    size_t pos = 0;
+    std::array<T, taps - 1 + block_size> line{};
+};
+
+
+/*
+    filters and keeps every factor-th output. only the kept outputs are computed,
+    which costs the same taps / factor multiplies per input as a polyphase decomposition.
+*/
+template<typename T, size_t fraction, size_t coeff_fraction, size_t taps, size_t factor, typename A = product_t<T>, size_t block_size = 256>
+class fir_decimator{
+    static_assert(factor > 0, "decimation factor must be positive");
+
+public:
+    using sample_type = fixed<T, fraction>;
+    using coeff_type = fixed<T, coeff_fraction>;
+
+    constexpr fir_decimator() = default;
+
+    constexpr explicit fir_decimator(const std::array<coeff_type, taps>& coefficients){
+        set_coefficients(coefficients);
+    }
+
+    constexpr void set_coefficients(std::span<const coeff_type, taps> coefficients){
+        for(size_t k = 0; k < taps; k++) h[k] = coefficients[taps - 1 - k].v;
+    }
+
+    constexpr void reset(){
+        line.fill(0);
+        phase = 0;
+    }
+
+    //returns the number of output samples written, at most in.size() / factor + 1
+    size_t process(std::span<const sample_type> in, std::span<sample_type> out){
+        size_t written = 0;
+        for(size_t start = 0; start < in.size(); start += block_size){
+            size_t n = std::min(block_size, in.size() - start);
+            for(size_t i = 0; i < n; i++) line[taps - 1 + i] = in[start + i].v;
+            size_t i = phase;
+            for(; i < n; i += factor){
+                assert(written < out.size());
+                A acc = fir_dot<A>(h.data(), &line[i], taps);
+                out[written++] = fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, coeff_fraction)));
+            }
+            phase = i - n;
+            for(size_t j = 0; j < taps - 1; j++) line[j] = line[n + j];
+        }
+        return written;
+    }
+
+private:
+    std::array<T, taps> h{};
+    std::array<T, taps - 1 + block_size> line{};
+    size_t phase = 0;
+};
+
+
+/*
+    upsamples by `factor` as if factor - 1 zeros were inserted after every input sample and the
+    result filtered with h. the zero products are skipped by splitting h into `factor` polyphase
+    sub filters h[p + factor * k], each of which runs at the input rate.
+    zero stuffing divides the gain by factor, design h with a gain of factor to compensate.
+*/
+template<typename T, size_t fraction, size_t coeff_fraction, size_t taps, size_t factor, typename A = product_t<T>>
+class fir_interpolator{
+    static_assert(factor > 0, "interpolation factor must be positive");
+    constexpr static size_t sub_taps = (taps + factor - 1) / factor;
+
+public:
+    using sample_type = fixed<T, fraction>;
+    using coeff_type = fixed<T, coeff_fraction>;
+
+    constexpr fir_interpolator() = default;
+
+    constexpr explicit fir_interpolator(const std::array<coeff_type, taps>& coefficients){
+        set_coefficients(coefficients);
+    }
+
+    constexpr void set_coefficients(std::span<const coeff_type, taps> coefficients){
+        for(size_t p = 0; p < factor; p++){
+            for(size_t k = 0; k < sub_taps; k++){
+                size_t idx = p + factor * k;
+                //reversed like fir_filter so the sub filter walks the ring forward
+                phases[p][sub_taps - 1 - k] = idx < taps ? coefficients[idx].v : T{0};
+            }
+        }
+    }
+
+    constexpr void reset(){
+        ring.fill(0);
+        pos = 0;
+    }
+
+    //writes in.size() * factor output samples
+    void process(std::span<const sample_type> in, std::span<sample_type> out){
+        assert(out.size() >= in.size() * factor);
+        for(size_t i = 0; i < in.size(); i++){
+            pos = pos + 1 == sub_taps ? 0 : pos + 1;
+            size_t newest = pos == 0 ? sub_taps - 1 : pos - 1;
+            ring[newest] = in[i].v;
+            ring[newest + sub_taps] = in[i].v;
+            for(size_t p = 0; p < factor; p++){
+                A acc = fir_dot<A>(phases[p].data(), &ring[pos], sub_taps);
+                out[i * factor + p] = fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, coeff_fraction)));
+            }
+        }
+    }
+
+private:
+    std::array<std::array<T, sub_taps>, factor> phases{};
+    std::array<T, 2 * sub_taps> ring{};
+    size_t pos = 0;
+};
+
+}//namespace fixed_point
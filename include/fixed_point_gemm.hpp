@@ -0,0 +1,127 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_parallel.hpp"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+/*
+    requantizes an accumulator holding frac_a + frac_b fractional bits to the output format.
+    with a per row scale the accumulator is first multiplied by the scale in Q30, i.e. a factor in [-2, 2).
+    an accumulator of up to 32 bits times the scale fits into 64 bits, wider ones are scaled in 128 bits.
+    rounds to nearest and saturates.
+*/
+template<typename To, size_t fo, size_t frac_a, size_t frac_b, typename A>
+inline To requantize(A acc, const fixed<int32_t, 30>* scale){
+    constexpr int shift = static_cast<int>(frac_a + frac_b) - static_cast<int>(fo);
+    using W = std::conditional_t<sizeof(A) <= 4, int64_t, wide_int<128>>;
+    W x = W(acc);
+    int total = shift;
+    if(scale){
+        x = x * W(scale->v);
+        total += 30;
+    }
+    if(total >= 0) return saturate<To>(rounding_shift_right(x, static_cast<size_t>(total)));
+    return saturate<To>(x * (W(1) << static_cast<size_t>(-total)));
+}
+
+/*
+    c = a * b for row major a (m x k), b (k x n) and c (m x n) of narrow fixed types.
+    products accumulate in Acc and are requantized to the format of c once, per tensor or with a per row scale.
+
+    b is packed transposed once so every element of c is a contiguous dot product over k.
+    c is computed in tiles of tile_m x tile_n which walk k in steps of tile_k, so the rows of a and
+    columns of b a tile needs stay in cache. four columns are computed together to reuse each load of a.
+    the inner loops are plain integer dot products the compiler vectorizes, pmaddwd for 16 bit types.
+    the default accumulator is a signed 32 bit integer, which also covers mixing unsigned and signed inputs.
+    sum(|a| * |b|) over k must fit into it, pass int64_t for more headroom.
+    tiles of rows are spread over `threads` threads.
+*/
+template<typename Ta, size_t fa, typename Tb, size_t fb, typename To, size_t fo, typename Acc = int32_t>
+inline void gemm(std::span<const fixed<Ta, fa>> a, std::span<const fixed<Tb, fb>> b, std::span<fixed<To, fo>> c,
+                 size_t m, size_t n, size_t k, std::span<const fixed<int32_t, 30>> row_scale = {}, size_t threads = 1){
+    static_assert(sizeof(Ta) <= 2 and sizeof(Tb) <= 2, "gemm is meant for 8 and 16 bit inputs");
+    assert(a.size() >= m * k and b.size() >= k * n and c.size() >= m * n);
+    assert(row_scale.empty() or row_scale.size() >= m);
+    constexpr size_t tile_m = 32;
+    constexpr size_t tile_n = 32;
+    constexpr size_t tile_k = 512;
+
+    std::vector<Tb> bt(n * k);
+    for(size_t kk = 0; kk < k; kk++){
+        for(size_t j = 0; j < n; j++) bt[j * k + kk] = b[kk * n + j].v;
+    }
+
+    size_t row_tiles = (m + tile_m - 1) / tile_m;
+    parallel_rows(row_tiles, threads, [&](size_t first_tile, size_t last_tile){
+        std::array<Acc, tile_m * tile_n> acc;
+        for(size_t i0 = first_tile * tile_m; i0 < std::min(m, last_tile * tile_m); i0 += tile_m){
+            size_t mi = std::min(tile_m, m - i0);
+            for(size_t j0 = 0; j0 < n; j0 += tile_n){
+                size_t nj = std::min(tile_n, n - j0);
+                acc.fill(0);
+                for(size_t k0 = 0; k0 < k; k0 += tile_k){
+                    size_t kc = std::min(tile_k, k - k0);
+                    for(size_t i = 0; i < mi; i++){
+                        const fixed<Ta, fa>* ar = &a[(i0 + i) * k + k0];
+                        Acc* out = &acc[i * tile_n];
+                        size_t j = 0;
+                        for(; j + 4 <= nj; j += 4){
+                            const Tb* b0 = &bt[(j0 + j) * k + k0];
+                            const Tb* b1 = b0 + k;
+                            const Tb* b2 = b1 + k;
+                            const Tb* b3 = b2 + k;
+                            Acc s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                            for(size_t kk = 0; kk < kc; kk++){
+                                Acc x = ar[kk].v;
+                                s0 += x * b0[kk];
+                                s1 += x * b1[kk];
+                                s2 += x * b2[kk];
+                                s3 += x * b3[kk];
+                            }
+                            out[j] += s0;
+                            out[j + 1] += s1;
+                            out[j + 2] += s2;
+                            out[j + 3] += s3;
+                        }
+                        for(; j < nj; j++){
+                            const Tb* bj = &bt[(j0 + j) * k + k0];
+                            Acc s = 0;
+                            for(size_t kk = 0; kk < kc; kk++) s += static_cast<Acc>(ar[kk].v) * bj[kk];
+                            out[j] += s;
+                        }
+                    }
+                }
+                for(size_t i = 0; i < mi; i++){
+                    const fixed<int32_t, 30>* scale = row_scale.empty() ? nullptr : &row_scale[i0 + i];
+                    for(size_t j = 0; j < nj; j++){
+                        c[(i0 + i) * n + j0 + j].v = requantize<To, fo, fa, fb>(acc[i * tile_n + j], scale);
+                    }
+                }
+            }
+        }
+    });
+}
+
+//y = a * x for row major a (m x k), requantized like gemm
+template<typename Ta, size_t fa, typename Tb, size_t fb, typename To, size_t fo, typename Acc = int32_t>
+inline void gemv(std::span<const fixed<Ta, fa>> a, std::span<const fixed<Tb, fb>> x, std::span<fixed<To, fo>> y,
+                 size_t m, size_t k, std::span<const fixed<int32_t, 30>> row_scale = {}, size_t threads = 1){
+    static_assert(sizeof(Ta) <= 2 and sizeof(Tb) <= 2, "gemv is meant for 8 and 16 bit inputs");
+    assert(a.size() >= m * k and x.size() >= k and y.size() >= m);
+    assert(row_scale.empty() or row_scale.size() >= m);
+    parallel_rows(m, threads, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            const fixed<Ta, fa>* ar = &a[i * k];
+            Acc s = 0;
+            for(size_t kk = 0; kk < k; kk++) s += static_cast<Acc>(ar[kk].v) * x[kk].v;
+            const fixed<int32_t, 30>* scale = row_scale.empty() ? nullptr : &row_scale[i];
+            y[i].v = requantize<To, fo, fa, fb>(s, scale);
+        }
+    });
+}
+
+}//namespace fixed_point
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <array>
+#include <span>
+
+namespace fixed_point{
+
+//y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+template<typename T, size_t coeff_fraction>
+struct biquad_coefficients{
+    fixed<T, coeff_fraction> b0;
+    fixed<T, coeff_fraction> b1;
+    fixed<T, coeff_fraction> b2;
+    fixed<T, coeff_fraction> a1;
+    fixed<T, coeff_fraction> a2;
+};
+
+enum class biquad_form{
+    direct_form_1,      //four narrow states per section, supports noise shaping
+    transposed_form_2   //two states per section kept at full accumulator width
+};
+
+//error feedback for direct form 1. the quantization error of the last outputs is added back
+//before the next one is rounded, which pushes the noise away from dc where low precision poles hurt most
+enum class noise_shaping{
+    none,
+    first_order,    //e(z) (1 - z^-1)
+    second_order    //e(z) (1 - z^-1)^2
+};
+
+/*
+    cascade of biquad sections applied to `channels` independent interleaved channels.
+    the recursion forbids vectorizing over time, so all state is laid out [section][channel]
+    and the inner loop runs over channels with the coefficients broadcast, which the compiler vectorizes.
+    outputs of every section saturate to the range of T.
+    from 32 bit samples on the accumulator is only as wide as a single product, so the sums fit only if the
+    magnitudes of the five coefficients of a section add up to less than 2^(bits of T - coeff_fraction),
+    e.g. 4 for 32 bit samples with Q30 coefficients. stable sections have |a1| < 2 and |a2| < 1,
+    which leaves room for the b coefficients of a filter with a gain around 1. fits_accumulator() checks this.
+*/
+template<typename T, size_t fraction, size_t coeff_fraction, size_t sections, size_t channels,
+         biquad_form form = biquad_form::direct_form_1, noise_shaping shaping = noise_shaping::none>
+class biquad_cascade{
+    static_assert(std::is_signed_v<T>, "biquads need a signed type");
+    static_assert(form == biquad_form::direct_form_1 or shaping == noise_shaping::none,
+                  "noise shaping is only available for direct form 1, transposed form 2 keeps its states unrounded");
+
+public:
+    using sample_type = fixed<T, fraction>;
+    using coeff_type = biquad_coefficients<T, coeff_fraction>;
+    using A = accumulator_t<T>;
+
+    constexpr biquad_cascade() = default;
+
+    constexpr explicit biquad_cascade(const std::array<coeff_type, sections>& c) : coeffs(c){
+        for([[maybe_unused]] const auto& section : c) assert(fits_accumulator(section));
+    }
+
+    constexpr void set_section(size_t s, const coeff_type& c){
+        assert(fits_accumulator(c));
+        coeffs[s] = c;
+    }
+
+    //whether a section with these coefficients can not overflow the accumulator, whatever the input
+    constexpr static bool fits_accumulator(const coeff_type& c){
+        if constexpr(sizeof(T) < 4){
+            return true;
+        }
+        else{
+            //|acc| <= sum |c| 2^(bits - 1) plus less than 3 2^coeff_fraction of error feedback
+            using W = wide_uint<128>;
+            auto magnitude = [](T v){
+                return W(v < 0 ? uint64_t{0} - static_cast<uint64_t>(v) : static_cast<uint64_t>(v));
+            };
+            W sum = magnitude(c.b0.v) + magnitude(c.b1.v) + magnitude(c.b2.v) + magnitude(c.a1.v) + magnitude(c.a2.v);
+            return sum <= (W(1) << (sizeof(T) * 8)) - W(4);
+        }
+    }
+
+    constexpr void reset(){
+        state = {};
+    }
+
+    //in and out hold frames of `channels` interleaved samples, in place processing is allowed
+    void process(std::span<const sample_type> in, std::span<sample_type> out){
+        assert(in.size() % channels == 0 and out.size() >= in.size());
+        std::array<T, channels> x;
+        for(size_t frame = 0; frame < in.size(); frame += channels){
+            for(size_t ch = 0; ch < channels; ch++) x[ch] = in[frame + ch].v;
+            for(size_t s = 0; s < sections; s++){
+                if constexpr(form == biquad_form::direct_form_1){
+                    direct_form_1_section(s, x);
+                }
+                else{
+                    transposed_form_2_section(s, x);
+                }
+            }
+            for(size_t ch = 0; ch < channels; ch++) out[frame + ch].v = x[ch];
+        }
+    }
+
+private:
+    constexpr static A mask = (A{1} << coeff_fraction) - 1;
+
+    void direct_form_1_section(size_t s, std::array<T, channels>& x){
+        const A b0 = coeffs[s].b0.v, b1 = coeffs[s].b1.v, b2 = coeffs[s].b2.v;
+        const A a1 = coeffs[s].a1.v, a2 = coeffs[s].a2.v;
+        auto& st = state[s];
+        for(size_t ch = 0; ch < channels; ch++){
+            A acc = b0 * x[ch] + b1 * st.x1[ch] + b2 * st.x2[ch] - a1 * st.y1[ch] - a2 * st.y2[ch];
+            T y;
+            if constexpr(shaping == noise_shaping::none){
+                y = saturate<T>(rounding_shift_right(acc, coeff_fraction));
+            }
+            else{
+                if constexpr(shaping == noise_shaping::first_order){
+                    acc += st.e1[ch];
+                }
+                else{
+                    acc += 2 * st.e1[ch] - st.e2[ch];
+                    st.e2[ch] = st.e1[ch];
+                }
+                st.e1[ch] = acc & mask;
+                y = saturate<T>(acc >> coeff_fraction);
+            }
+            st.x2[ch] = st.x1[ch];
+            st.x1[ch] = x[ch];
+            st.y2[ch] = st.y1[ch];
+            st.y1[ch] = y;
+            x[ch] = y;
+        }
+    }
+
+    void transposed_form_2_section(size_t s, std::array<T, channels>& x){
+        const A b0 = coeffs[s].b0.v, b1 = coeffs[s].b1.v, b2 = coeffs[s].b2.v;
+        const A a1 = coeffs[s].a1.v, a2 = coeffs[s].a2.v;
+        auto& st = state[s];
+        for(size_t ch = 0; ch < channels; ch++){
+            A in = x[ch];
+            T y = saturate<T>(rounding_shift_right(b0 * in + st.s1[ch], coeff_fraction));
+            A out = y;
+            st.s1[ch] = b1 * in - a1 * out + st.s2[ch];
+            st.s2[ch] = b2 * in - a2 * out;
+            x[ch] = y;
+        }
+    }
+
+    struct direct_form_1_state{
+        std::array<T, channels> x1{}, x2{}, y1{}, y2{};
+        std::array<A, channels> e1{}, e2{};
+    };
+
+    struct transposed_form_2_state{
+        std::array<A, channels> s1{}, s2{};
+    };
+
+    using section_state = std::conditional_t<form == biquad_form::direct_form_1, direct_form_1_state, transposed_form_2_state>;
+
+    std::array<coeff_type, sections> coeffs{};
+    std::array<section_state, sections> state{};
+};
+
+}//namespace fixed_point
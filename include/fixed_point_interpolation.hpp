@@ -0,0 +1,210 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+/*
+    a + (b - a) * t for t in [0, 1], rounded down like operator*.
+    t has its own type, so 1.0 can be represented even when the type of a and b has no integer bits,
+    e.g. fixed<uint8_t, 8> pixels with a fixed<uint16_t, 8> weight. t = 0 gives a and t = 1 gives b exactly.
+    the difference needs one bit more than T, when its product with t can exceed 63 bits it is formed in 128 bits.
+*/
+template<typename T, size_t fraction, typename W, size_t weight_fraction>
+constexpr inline fixed<T, fraction> lerp(fixed<T, fraction> a, fixed<T, fraction> b, fixed<W, weight_fraction> t){
+    static_assert(sizeof(T) <= 4 and sizeof(W) <= 4, "lerp needs types of at most 32 bits");
+    int64_t difference = static_cast<int64_t>(b.v) - static_cast<int64_t>(a.v);
+    int64_t step;
+    if constexpr(sizeof(T) * 8 + 1 + sizeof(W) * 8 <= 63){
+        step = (difference * static_cast<int64_t>(t.v)) >> weight_fraction;
+    }
+    else{
+        step = static_cast<int64_t>(wide_product(difference, static_cast<int64_t>(t.v)) >> weight_fraction);
+    }
+    return fp_from_bits<T, fraction>(static_cast<T>(static_cast<int64_t>(a.v) + step));
+}
+
+/*
+    0 below edge0, 1 above edge1 and the hermite curve 3t^2 - 2t^3 in between.
+    t comes from operator/ and clamp, the cubic is evaluated exactly in a wide integer and rounded once,
+    so unlike a chain of truncating multiplies the result never decreases when x grows.
+*/
+template<typename T, size_t fraction>
+constexpr inline fixed<T, fraction> smoothstep(fixed<T, fraction> edge0, fixed<T, fraction> edge1, fixed<T, fraction> x){
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "smoothstep needs a builtin integer type of at most 32 bits");
+    static_assert(fraction < sizeof(T) * 8 - (std::is_signed_v<T> ? 1 : 0), "smoothstep needs 1.0 to be representable");
+    assert(edge0 < edge1);
+    const auto zero = fp_from_bits<T, fraction>(0);
+    const auto one = fp_from_bits<T, fraction>(static_cast<T>(T(1) << fraction));
+    if(x <= edge0) return zero;
+    if(x >= edge1) return one;
+    int64_t t = clamp((x - edge0) / (edge1 - edge0), zero, one).v;
+    auto cubic = wide_product(t * t, (int64_t{3} << fraction) - 2 * t);
+    return fp_from_bits<T, fraction>(static_cast<T>(rounding_shift_right(cubic, 2 * fraction)));
+}
+
+
+enum class resample_filter{bilinear, bicubic};
+
+/*
+    weights of a separable resampling pass from src_size to dst_size samples, output i is
+    sum over k < taps of weights[i * taps + k] * input[first[i] + k].
+    the weights are in Q14 and every row sums to exactly 1 << 14, so a constant input stays constant.
+    sample centers are aligned, output i sits at (i + 0.5) * src_size / dst_size - 0.5 in the input,
+    and taps falling outside the input are folded onto the edge sample.
+*/
+struct resample_weights{
+    constexpr static size_t weight_fraction = 14;
+
+    size_t taps = 0;
+    std::vector<size_t> first;
+    std::vector<int16_t> weights;
+
+    size_t size() const{
+        return first.size();
+    }
+};
+
+namespace detail{
+
+//keys cubic convolution kernel with a = -0.5, the catmull rom spline
+inline double cubic_kernel(double x){
+    x = std::abs(x);
+    if(x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+    if(x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+}//namespace detail
+
+//the tables are built once per size pair in double, the passes themselves are integer only
+inline resample_weights make_resample_weights(size_t src_size, size_t dst_size, resample_filter filter){
+    assert(src_size > 0 and dst_size > 0);
+    constexpr int32_t one = 1 << resample_weights::weight_fraction;
+    const size_t filter_taps = filter == resample_filter::bilinear ? 2 : 4;
+    resample_weights result;
+    result.taps = std::min(filter_taps, src_size);
+    result.first.resize(dst_size);
+    result.weights.assign(dst_size * result.taps, 0);
+
+    const double scale = static_cast<double>(src_size) / static_cast<double>(dst_size);
+    const ptrdiff_t last_first = static_cast<ptrdiff_t>(src_size - result.taps);
+    for(size_t i = 0; i < dst_size; i++){
+        double center = (static_cast<double>(i) + 0.5) * scale - 0.5;
+        ptrdiff_t base = static_cast<ptrdiff_t>(std::floor(center)) - static_cast<ptrdiff_t>(filter_taps / 2 - 1);
+        double t = center - std::floor(center);
+        ptrdiff_t first = std::clamp<ptrdiff_t>(base, 0, last_first);
+        result.first[i] = static_cast<size_t>(first);
+
+        int16_t* row = &result.weights[i * result.taps];
+        int32_t sum = 0;
+        size_t largest = 0;
+        for(size_t k = 0; k < filter_taps; k++){
+            double offset = static_cast<double>(k) - static_cast<double>(filter_taps / 2 - 1) - t;
+            double weight = filter == resample_filter::bilinear ? 1.0 - std::abs(offset) : detail::cubic_kernel(offset);
+            ptrdiff_t source = std::clamp<ptrdiff_t>(base + static_cast<ptrdiff_t>(k), 0, static_cast<ptrdiff_t>(src_size) - 1);
+            size_t slot = static_cast<size_t>(std::clamp<ptrdiff_t>(source - first, 0, static_cast<ptrdiff_t>(result.taps) - 1));
+            int32_t q = static_cast<int32_t>(std::lround(weight * one));
+            row[slot] = static_cast<int16_t>(row[slot] + q);
+            sum += q;
+        }
+        //rounding error of the row goes to its largest weight
+        for(size_t k = 1; k < result.taps; k++){
+            if(row[k] > row[largest]) largest = k;
+        }
+        row[largest] = static_cast<int16_t>(row[largest] + one - sum);
+    }
+    return result;
+}
+
+
+namespace detail{
+
+template<typename T>
+using resample_accumulator_t = std::conditional_t<sizeof(T) <= 2, int32_t, int64_t>;
+
+template<typename T, typename A>
+constexpr inline T resample_round(A acc){
+    return saturate<T>(rounding_shift_right(acc, resample_weights::weight_fraction));
+}
+
+}//namespace detail
+
+/*
+    horizontal pass, resamples each of the height rows of src (width values each) to weights.size() values.
+    bicubic weights overshoot, results are saturated to the range of T.
+*/
+template<typename T, size_t fraction>
+inline void resample_horizontal(std::span<const fixed<T, fraction>> src, size_t width, size_t height,
+                                std::span<fixed<T, fraction>> dst, const resample_weights& weights, size_t threads = 1){
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "resampling needs a builtin integer type of at most 32 bits");
+    using A = detail::resample_accumulator_t<T>;
+    const size_t dst_width = weights.size();
+    const size_t taps = weights.taps;
+    assert(src.size() >= width * height and dst.size() >= dst_width * height);
+    assert(dst_width == 0 or weights.first.back() + taps <= width);
+
+    parallel_rows(height, threads, [&](size_t begin, size_t end){
+        for(size_t y = begin; y < end; y++){
+            const fixed<T, fraction>* in = src.data() + y * width;
+            fixed<T, fraction>* out = dst.data() + y * dst_width;
+            for(size_t x = 0; x < dst_width; x++){
+                const fixed<T, fraction>* window = in + weights.first[x];
+                const int16_t* w = &weights.weights[x * taps];
+                A acc = 0;
+                for(size_t k = 0; k < taps; k++) acc += static_cast<A>(w[k]) * static_cast<A>(window[k].v);
+                out[x] = fp_from_bits<T, fraction>(detail::resample_round<T>(acc));
+            }
+        }
+    });
+}
+
+/*
+    vertical pass, resamples each column of src (height rows of width values) to weights.size() rows.
+    every output row is a weighted sum of whole input rows, the inner loop runs along the row with the same
+    weight for all lanes and has no dependency between them, so it vectorizes to full width.
+    16 bit samples are read with half the memory traffic of float.
+*/
+template<typename T, size_t fraction>
+inline void resample_vertical(std::span<const fixed<T, fraction>> src, size_t width, size_t height,
+                              std::span<fixed<T, fraction>> dst, const resample_weights& weights, size_t threads = 1){
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "resampling needs a builtin integer type of at most 32 bits");
+    using A = detail::resample_accumulator_t<T>;
+    const size_t dst_height = weights.size();
+    const size_t taps = weights.taps;
+    assert(src.size() >= width * height and dst.size() >= width * dst_height);
+    assert(dst_height == 0 or weights.first.back() + taps <= height);
+
+    parallel_rows(dst_height, threads, [&](size_t begin, size_t end){
+        std::vector<A> acc(width);
+        for(size_t y = begin; y < end; y++){
+            std::fill(acc.begin(), acc.end(), A(0));
+            for(size_t k = 0; k < taps; k++){
+                const A w = weights.weights[y * taps + k];
+                const fixed<T, fraction>* in = src.data() + (weights.first[y] + k) * width;
+                for(size_t x = 0; x < width; x++) acc[x] += w * static_cast<A>(in[x].v);
+            }
+            fixed<T, fraction>* out = dst.data() + y * width;
+            for(size_t x = 0; x < width; x++) out[x] = fp_from_bits<T, fraction>(detail::resample_round<T>(acc[x]));
+        }
+    });
+}
+
+//resamples a width x height image to dst_width x dst_height, horizontal pass first, then vertical
+template<typename T, size_t fraction>
+inline void resample(std::span<const fixed<T, fraction>> src, size_t width, size_t height,
+                     std::span<fixed<T, fraction>> dst, size_t dst_width, size_t dst_height,
+                     resample_filter filter, size_t threads = 1){
+    assert(dst.size() >= dst_width * dst_height);
+    std::vector<fixed<T, fraction>> intermediate(dst_width * height);
+    resample_horizontal(src, width, height, std::span(intermediate), make_resample_weights(width, dst_width, filter), threads);
+    resample_vertical(std::span<const fixed<T, fraction>>(intermediate), dst_width, height, dst,
+                      make_resample_weights(height, dst_height, filter), threads);
+}
+
+}//namespace fixed_point
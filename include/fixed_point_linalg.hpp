@@ -0,0 +1,414 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+template<typename T, size_t fraction, size_t N>
+struct fixed_vec{
+    using value_type = fixed<T, fraction>;
+
+    std::array<value_type, N> e;
+
+    constexpr value_type& operator[](size_t i){
+        return e[i];
+    }
+
+    constexpr const value_type& operator[](size_t i) const{
+        return e[i];
+    }
+
+    constexpr static size_t size(){
+        return N;
+    }
+};
+
+template<typename T, size_t fraction, size_t R, size_t C>
+struct fixed_mat{
+    using row_type = fixed_vec<T, fraction, C>;
+
+    std::array<row_type, R> rows;
+
+    constexpr row_type& operator[](size_t r){
+        return rows[r];
+    }
+
+    constexpr const row_type& operator[](size_t r) const{
+        return rows[r];
+    }
+
+    constexpr static fixed_mat identity(){
+        static_assert(R == C, "identity matrix must be square");
+        fixed_mat result{};
+        for(size_t i = 0; i < R; i++) result[i][i] = make_fixed<T, fraction>(1);
+        return result;
+    }
+};
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline bool operator==(const fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    for(size_t i = 0; i < N; i++){
+        if(a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> operator+(const fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    fixed_vec<T, fraction, N> result;
+    for(size_t i = 0; i < N; i++) result[i] = a[i] + b[i];
+    return result;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> operator-(const fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    fixed_vec<T, fraction, N> result;
+    for(size_t i = 0; i < N; i++) result[i] = a[i] - b[i];
+    return result;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> operator-(const fixed_vec<T, fraction, N>& a){
+    fixed_vec<T, fraction, N> result;
+    for(size_t i = 0; i < N; i++) result[i] = -a[i];
+    return result;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> operator*(const fixed_vec<T, fraction, N>& a, fixed<T, fraction> s){
+    fixed_vec<T, fraction, N> result;
+    for(size_t i = 0; i < N; i++) result[i] = a[i] * s;
+    return result;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> operator*(fixed<T, fraction> s, const fixed_vec<T, fraction, N>& a){
+    return a * s;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N>& operator+=(fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    a = a + b;
+    return a;
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N>& operator-=(fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    a = a - b;
+    return a;
+}
+
+namespace detail{
+
+/*
+    sums of products of components. a single product of 32 bit values needs up to 62 bits,
+    so two of them at full scale already overflow int64 and 32 bit types are summed in 128 bits.
+*/
+template<typename T>
+using dot_accumulator_t = std::conditional_t<sizeof(T) == 4, wide_int<128, std::is_signed_v<T>>, accumulator_t<T>>;
+
+//the same for sums of squares, which are never negative
+template<typename T>
+using square_sum_t = std::conditional_t<sizeof(T) <= 2, uint64_t, wide_uint<128>>;
+
+template<typename T, typename A>
+constexpr inline void multiply_accumulate(A& acc, T a, T b){
+    using P = accumulator_t<T>;
+    acc += A(static_cast<P>(a) * static_cast<P>(b));
+}
+
+template<typename T, size_t fraction, typename A>
+constexpr inline fixed<T, fraction> round_sum(A acc){
+    return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, fraction)));
+}
+
+/*
+    exact sum of products of 32 bit components in plain 64 bit arithmetic, for the loops that should vectorize.
+    every product is split into its upper and lower 32 bits, which are summed separately,
+    so neither sum can overflow for less than 2^31 terms. the sum is hi * 2^32 + lo.
+*/
+struct split_sum{
+    int64_t hi = 0;
+    int64_t lo = 0;     //never negative
+};
+
+template<typename T>
+using batch_accumulator_t = std::conditional_t<sizeof(T) == 4, split_sum, dot_accumulator_t<T>>;
+
+template<typename T>
+constexpr inline void multiply_accumulate(split_sum& acc, T a, T b){
+    using P = accumulator_t<T>;
+    P p = static_cast<P>(a) * static_cast<P>(b);
+    acc.hi += static_cast<int64_t>(p >> 32);
+    acc.lo += static_cast<int64_t>(p & 0xffffffff);
+}
+
+//carries lo over so it is below 2^32
+constexpr inline split_sum carry(split_sum acc){
+    return {acc.hi + (acc.lo >> 32), acc.lo & 0xffffffff};
+}
+
+template<typename T, size_t fraction>
+constexpr inline fixed<T, fraction> round_sum(split_sum acc){
+    static_assert(fraction <= 32);
+    acc = carry(acc);
+    //outside of these bounds the result does not fit any 32 bit type, clamping keeps the shift below in range
+    constexpr int64_t upper = int64_t{1} << fraction;
+    constexpr int64_t lower = -upper - 1;
+    int64_t hi = acc.hi > upper ? upper : acc.hi < lower ? lower : acc.hi;
+    return fp_from_bits<T, fraction>(saturate<T>((hi << (32 - fraction)) + rounding_shift_right(acc.lo, fraction)));
+}
+
+template<typename T>
+constexpr inline square_sum_t<T> to_square_sum(split_sum acc){
+    acc = carry(acc);
+    return (square_sum_t<T>(static_cast<uint64_t>(acc.hi)) << 32) + square_sum_t<T>(static_cast<uint64_t>(acc.lo));
+}
+
+template<typename T, typename A>
+constexpr inline square_sum_t<T> to_square_sum(A acc){
+    return square_sum_t<T>(acc);
+}
+
+}//namespace detail
+
+//sum of products, accumulated at full precision
+template<typename T, size_t fraction, size_t N>
+constexpr inline detail::dot_accumulator_t<T> wide_dot(const fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    detail::dot_accumulator_t<T> acc = 0;
+    for(size_t i = 0; i < N; i++) detail::multiply_accumulate(acc, a[i].v, b[i].v);
+    return acc;
+}
+
+//rounded once and saturated if it does not fit
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed<T, fraction> dot(const fixed_vec<T, fraction, N>& a, const fixed_vec<T, fraction, N>& b){
+    return detail::round_sum<T, fraction>(wide_dot(a, b));
+}
+
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed<T, fraction> length_squared(const fixed_vec<T, fraction, N>& a){
+    return dot(a, a);
+}
+
+//the sum of squares carries 2*fraction fractional bits, so its integer square root is already in the right format
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed<T, fraction> length(const fixed_vec<T, fraction, N>& a){
+    detail::square_sum_t<T> s(wide_dot(a, a));
+    return fp_from_bits<T, fraction>(saturate<T>(rounded_integer_sqrt(s)));
+}
+
+template<typename T, size_t fraction>
+constexpr inline fixed_vec<T, fraction, 3> cross(const fixed_vec<T, fraction, 3>& a, const fixed_vec<T, fraction, 3>& b){
+    static_assert(std::is_signed_v<T>, "cross product needs a signed type");
+    using A = accumulator_t<T>;
+    auto component = [](auto a0, auto b1, auto a1, auto b0){
+        A acc = static_cast<A>(a0.v) * b1.v - static_cast<A>(a1.v) * b0.v;
+        return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, fraction)));
+    };
+    fixed_vec<T, fraction, 3> result;
+    result[0] = component(a[1], b[2], a[2], b[1]);
+    result[1] = component(a[2], b[0], a[0], b[2]);
+    result[2] = component(a[0], b[1], a[1], b[0]);
+    return result;
+}
+
+//z component of the 3d cross product of two vectors in the plane
+template<typename T, size_t fraction>
+constexpr inline fixed<T, fraction> cross(const fixed_vec<T, fraction, 2>& a, const fixed_vec<T, fraction, 2>& b){
+    static_assert(std::is_signed_v<T>, "cross product needs a signed type");
+    using A = accumulator_t<T>;
+    A acc = static_cast<A>(a[0].v) * b[1].v - static_cast<A>(a[1].v) * b[0].v;
+    return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(acc, fraction)));
+}
+
+/*
+    1/sqrt(m) for m in [1, 4), both as Q30.
+    newton iterations y = y * (3 - m * y^2) / 2 need no division.
+    the initial guess is the line through (1, 1) and (4, 1/2), which is at most 19% off
+    so five iterations are enough for full Q30 precision.
+*/
+constexpr inline uint64_t inv_sqrt_q30(uint64_t m){
+    constexpr int64_t seven_sixths = 1252698795; //7/6 in Q30
+    int64_t y = seven_sixths - static_cast<int64_t>(m / 6);
+    for(int i = 0; i < 5; i++){
+        int64_t y2 = (y * y) >> 30;
+        int64_t my2 = static_cast<int64_t>((m * static_cast<uint64_t>(y2)) >> 30);
+        y = (y * ((int64_t{3} << 30) - my2)) >> 31;
+    }
+    return static_cast<uint64_t>(y);
+}
+
+/*
+    scales the vector by 1/sqrt(|a|^2) without any division.
+    |a|^2 is normalized to m = |a|^2 * 2^-k in [2^30, 2^32) with k even,
+    so 1/|a| = inv_sqrt_q30(m) * 2^-(30 + k - 2*fraction)/2
+    the components are scaled in 64 bits, which limits them to 32 bits.
+*/
+template<typename T, size_t fraction, size_t N>
+constexpr inline fixed_vec<T, fraction, N> normalize(const fixed_vec<T, fraction, N>& a){
+    static_assert(std::is_signed_v<T>, "normalize needs a signed type");
+    static_assert(sizeof(T) <= 4, "normalize scales the components in 64 bits");
+    using S = detail::square_sum_t<T>;
+    S s(wide_dot(a, a));
+    if(not s) return a;
+    int k = std::numeric_limits<S>::digits - leading_zeros(s) - 32;
+    if(k & 1) k++;
+    auto m = static_cast<uint64_t>(k >= 0 ? s >> static_cast<size_t>(k) : s << static_cast<size_t>(-k));
+    auto r = static_cast<int64_t>(inv_sqrt_q30(m));
+    int shift = 30 + (30 + k - 2 * static_cast<int>(fraction)) / 2;
+    fixed_vec<T, fraction, N> result;
+    for(size_t i = 0; i < N; i++){
+        int64_t p = static_cast<int64_t>(a[i].v) * r;
+        result[i].v = static_cast<T>(shift >= 0 ? rounding_shift_right(p, shift) : p << -shift);
+    }
+    return result;
+}
+
+template<typename T, size_t fraction, size_t R, size_t C>
+constexpr inline fixed_vec<T, fraction, R> operator*(const fixed_mat<T, fraction, R, C>& m, const fixed_vec<T, fraction, C>& v){
+    fixed_vec<T, fraction, R> result;
+    for(size_t r = 0; r < R; r++) result[r] = dot(m[r], v);
+    return result;
+}
+
+template<typename T, size_t fraction, size_t R, size_t K, size_t C>
+constexpr inline fixed_mat<T, fraction, R, C> operator*(const fixed_mat<T, fraction, R, K>& a, const fixed_mat<T, fraction, K, C>& b){
+    fixed_mat<T, fraction, R, C> result;
+    for(size_t r = 0; r < R; r++){
+        for(size_t c = 0; c < C; c++){
+            detail::batch_accumulator_t<T> acc{};
+            for(size_t k = 0; k < K; k++) detail::multiply_accumulate(acc, a[r][k].v, b[k][c].v);
+            result[r][c] = detail::round_sum<T, fraction>(acc);
+        }
+    }
+    return result;
+}
+
+template<typename T, size_t fraction, size_t R, size_t C>
+constexpr inline fixed_mat<T, fraction, C, R> transpose(const fixed_mat<T, fraction, R, C>& m){
+    fixed_mat<T, fraction, C, R> result;
+    for(size_t r = 0; r < R; r++){
+        for(size_t c = 0; c < C; c++) result[c][r] = m[r][c];
+    }
+    return result;
+}
+
+template<typename T, size_t fraction, size_t R, size_t C>
+constexpr inline bool operator==(const fixed_mat<T, fraction, R, C>& a, const fixed_mat<T, fraction, R, C>& b){
+    for(size_t r = 0; r < R; r++){
+        if(!(a[r] == b[r])) return false;
+    }
+    return true;
+}
+
+
+/*
+    structure of arrays container for many vectors, one contiguous array per component.
+    the batch kernels below loop over the vectors with the component loop fully unrolled,
+    which lets the compiler vectorize across vectors. they sum 32 bit products in two int64 lanes
+    instead of the 128 bit accumulator of dot, which would serialize the loop.
+*/
+template<typename T, size_t fraction, size_t N>
+struct fixed_vec_batch{
+    using value_type = fixed<T, fraction>;
+
+    std::array<std::vector<value_type>, N> components;
+
+    fixed_vec_batch() = default;
+
+    explicit fixed_vec_batch(size_t count){
+        resize(count);
+    }
+
+    void resize(size_t count){
+        for(auto& c : components) c.resize(count);
+    }
+
+    size_t size() const{
+        return components[0].size();
+    }
+
+    std::span<value_type> component(size_t c){
+        return components[c];
+    }
+
+    std::span<const value_type> component(size_t c) const{
+        return components[c];
+    }
+
+    fixed_vec<T, fraction, N> get(size_t i) const{
+        fixed_vec<T, fraction, N> result;
+        for(size_t c = 0; c < N; c++) result[c] = components[c][i];
+        return result;
+    }
+
+    void set(size_t i, const fixed_vec<T, fraction, N>& v){
+        for(size_t c = 0; c < N; c++) components[c][i] = v[c];
+    }
+};
+
+template<typename T, size_t fraction, size_t N>
+inline void batch_dot(const fixed_vec_batch<T, fraction, N>& a, const fixed_vec_batch<T, fraction, N>& b, std::span<fixed<T, fraction>> out){
+    assert(a.size() == b.size() and out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++){
+        detail::batch_accumulator_t<T> acc{};
+        for(size_t c = 0; c < N; c++) detail::multiply_accumulate(acc, a.components[c][i].v, b.components[c][i].v);
+        out[i] = detail::round_sum<T, fraction>(acc);
+    }
+}
+
+template<typename T, size_t fraction, size_t N>
+inline void batch_length(const fixed_vec_batch<T, fraction, N>& a, std::span<fixed<T, fraction>> out){
+    assert(out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++){
+        detail::batch_accumulator_t<T> acc{};
+        for(size_t c = 0; c < N; c++) detail::multiply_accumulate(acc, a.components[c][i].v, a.components[c][i].v);
+        out[i].v = saturate<T>(rounded_integer_sqrt(detail::to_square_sum<T>(acc)));
+    }
+}
+
+template<typename T, size_t fraction>
+inline void batch_cross(const fixed_vec_batch<T, fraction, 3>& a, const fixed_vec_batch<T, fraction, 3>& b, fixed_vec_batch<T, fraction, 3>& out){
+    assert(a.size() == b.size() and out.size() >= a.size());
+    static_assert(std::is_signed_v<T>, "cross product needs a signed type");
+    using A = accumulator_t<T>;
+    for(size_t c = 0; c < 3; c++){
+        const auto* a1 = a.components[(c + 1) % 3].data();
+        const auto* a2 = a.components[(c + 2) % 3].data();
+        const auto* b1 = b.components[(c + 1) % 3].data();
+        const auto* b2 = b.components[(c + 2) % 3].data();
+        auto* o = out.components[c].data();
+        for(size_t i = 0; i < a.size(); i++){
+            A acc = static_cast<A>(a1[i].v) * b2[i].v - static_cast<A>(a2[i].v) * b1[i].v;
+            o[i].v = saturate<T>(rounding_shift_right(acc, fraction));
+        }
+    }
+}
+
+template<typename T, size_t fraction, size_t N>
+inline void batch_normalize(const fixed_vec_batch<T, fraction, N>& a, fixed_vec_batch<T, fraction, N>& out){
+    assert(out.size() >= a.size());
+    for(size_t i = 0; i < a.size(); i++){
+        out.set(i, normalize(a.get(i)));
+    }
+}
+
+//out[i] = m * in[i] for every vector of the batch
+template<typename T, size_t fraction, size_t R, size_t C>
+inline void batch_transform(const fixed_mat<T, fraction, R, C>& m, const fixed_vec_batch<T, fraction, C>& in, fixed_vec_batch<T, fraction, R>& out){
+    assert(out.size() >= in.size());
+    for(size_t r = 0; r < R; r++){
+        auto* o = out.components[r].data();
+        for(size_t i = 0; i < in.size(); i++){
+            detail::batch_accumulator_t<T> acc{};
+            for(size_t c = 0; c < C; c++) detail::multiply_accumulate(acc, m[r][c].v, in.components[c][i].v);
+            o[i] = detail::round_sum<T, fraction>(acc);
+        }
+    }
+}
+
+}//namespace fixed_point
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "fixed_point_type.hpp"
+#include "fixed_point_wide_int.hpp"
+#include <cstdlib>
+#include <limits>
+#include <utility>
 
 namespace fixed_point{
 
@@ -91,7 +95,9 @@ constexpr inline fixed<T, fraction> operator*(fixed<T, fraction> a, fixed<T, fra
         }
     }
     else{
-        static_assert(!std::is_same_v<T, T>, "multiplication of 64 bit fixed point numbers is not implemented, sorry");
+        //64 bit and wide_int types, the exact product is a wide_int of twice the width
+        auto result = wide_product(a.v, b.v);
+        return fp_from_bits<T, fraction>(static_cast<T>(result >> fraction));
     }
     
 }
@@ -120,6 +126,63 @@ constexpr inline fixed<T, fraction>& operator*=(fixed<T, fraction>& a, fixed_con
     return a;
 }
 
+//integer type which holds the exact product of two T
+template<typename T>
+struct product_type{
+    using type = std::conditional_t<sizeof(T) <= 2,
+                                    std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>,
+                 std::conditional_t<sizeof(T) <= 4,
+                                    std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>,
+                                    wide_int<128, std::is_signed_v<T>>>>;
+};
+
+template<size_t bits, bool is_signed_int>
+struct product_type<wide_int<bits, is_signed_int>>{
+    using type = wide_int<2 * bits, is_signed_int>;
+};
+
+template<typename T>
+using product_t = typename product_type<T>::type;
+
+//integer type for sums of many products of T, so they can be rounded once at the end.
+//from 64 bits on this is just the product type, which leaves a single bit of headroom
+template<typename T>
+struct accumulator_type{
+    using type = std::conditional_t<sizeof(T) <= 4, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, product_t<T>>;
+};
+
+template<size_t bits, bool is_signed_int>
+struct accumulator_type<wide_int<bits, is_signed_int>>{
+    using type = product_t<wide_int<bits, is_signed_int>>;
+};
+
+template<typename T>
+using accumulator_t = typename accumulator_type<T>::type;
+
+//shifts right rounding to nearest, ties towards positive infinity
+template<typename A>
+constexpr inline A rounding_shift_right(A x, size_t shift){
+    if(shift == 0) return x;
+    return (x + (A{1} << (shift - 1))) >> shift;
+}
+
+//clamps a wide intermediate result to the range of T
+template<typename T, typename A>
+constexpr inline T saturate(A x){
+    if constexpr(std::is_integral_v<A>){
+        if(std::cmp_less(x, std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+        if(std::cmp_greater(x, std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    }
+    else{
+        //wide_int intermediates, wide enough to hold every value of T. an unsigned one can not be below the range
+        if constexpr(std::numeric_limits<A>::is_signed){
+            if(x < A(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+        }
+        if(x > A(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(x);
+}
+
 template<typename T, size_t fraction>
 constexpr inline fixed<T, fraction> correctly_rounded_division(fixed<T, fraction> a, fixed<T, fraction> b){
     if constexpr(sizeof(T) <= 2){
@@ -151,7 +214,18 @@ constexpr inline fixed<T, fraction> correctly_rounded_division(fixed<T, fraction
         }
     }
     else{
-        static_assert(!std::is_same_v<T, T>, "division of 64 bit fixed point numbers is not implemented, sorry");
+        //64 bit and wide_int types divide in the product type
+        using P = product_t<T>;
+        P x = P(a.v) << fraction;
+        P y = P(b.v);
+        if constexpr(std::numeric_limits<T>::is_signed){
+            P result = (x < 0) ^ (y < 0) ? ((x - y/2)/y) : ((x + y/2)/y);
+            return fp_from_bits<T, fraction>(static_cast<T>(result));
+        }
+        else{
+            P result = (x - y/2)/y;
+            return fp_from_bits<T, fraction>(static_cast<T>(result));
+        }
     }
 }
 
@@ -178,7 +252,9 @@ constexpr inline fixed<T, fraction> fast_division(fixed<T, fraction> a, fixed<T,
         }
     }
     else{
-        static_assert(!std::is_same_v<T, T>, "division of 64 bit fixed point numbers is not implemented, sorry");
+        using P = product_t<T>;
+        P result = (P(a.v) << fraction) / P(b.v);
+        return fp_from_bits<T, fraction>(static_cast<T>(result));
     }
 }
 
@@ -255,16 +331,14 @@ constexpr inline fixed<T, fraction> operator&=(fixed<T, fraction> a, T b){
 */
 template<typename T, size_t fraction>
 constexpr inline fixed<T, fraction> approx_sqrt(fixed<T, fraction> x){
-    int leading_zeros = std::countl_zero(static_cast<std::make_unsigned_t<T>>(x.v));
-    int highest_set_bit = (sizeof(T) * 8) - leading_zeros - 1;
-    return fp_from_bits<T, fraction>(1 << ((highest_set_bit + fraction)/2));
+    int highest_set_bit = (sizeof(T) * 8) - leading_zeros(x.v) - 1;
+    return fp_from_bits<T, fraction>(T(1) << ((highest_set_bit + fraction)/2));
 }
 
 template<typename T, size_t fraction>
 constexpr inline fixed<T, fraction> better_approx_sqrt(fixed<T, fraction> x){
-    int leading_zeros = std::countl_zero(static_cast<std::make_unsigned_t<T>>(x.v));
-    int highest_set_bit = (sizeof(T) * 8) - leading_zeros - 1;
-    auto initial_guess = fp_from_bits<T, fraction>(1 << ((highest_set_bit + fraction)/2));
+    int highest_set_bit = (sizeof(T) * 8) - leading_zeros(x.v) - 1;
+    auto initial_guess = fp_from_bits<T, fraction>(T(1) << ((highest_set_bit + fraction)/2));
     int shift_amount = (highest_set_bit + static_cast<int>(fraction))/2 - static_cast<int>(fraction);
     x.v = shift_amount >= 0 ? (x.v >> shift_amount) : x.v << (-shift_amount);
     initial_guess = initial_guess + x;
@@ -284,22 +358,50 @@ constexpr inline fixed<T, fraction> sqrt(fixed<T, fraction> x){
     return y;
 }
 
+//floor(sqrt(x)) of an unsigned integer, digit by digit so it needs no division
+template<typename U>
+constexpr inline U integer_sqrt(U x){
+    U result = 0;
+    U bit = U{1} << (std::numeric_limits<U>::digits - 2);
+    while(bit > x) bit >>= 2;
+    while(bit != 0){
+        if(x >= result + bit){
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else{
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+//sqrt(x) of an unsigned integer rounded to nearest
+template<typename U>
+constexpr inline U rounded_integer_sqrt(U x){
+    U result = integer_sqrt(x);
+    //(r + 1/2)^2 = r^2 + r + 1/4, so round up if the remainder exceeds r
+    if(x - result * result > result) result++;
+    return result;
+}
+
 
 template<typename T, size_t fraction>
 constexpr inline bool same_top_most_bit(fixed<T, fraction> a, fixed<T, fraction> b){
-    int leading_zeros_a = std::countl_zero(static_cast<std::make_unsigned_t<T>>(a.v));
-    int leading_zeros_b = std::countl_zero(static_cast<std::make_unsigned_t<T>>(b.v));
-    return leading_zeros_a == leading_zeros_b;
+    return leading_zeros(a.v) == leading_zeros(b.v);
 }
 
 template<typename T, size_t fraction>
 constexpr inline bool same_up_to_one_bit(fixed<T, fraction> a, fixed<T, fraction> b){
-    return std::abs(a.v - b.v) <= 1;
+    using std::abs;
+    return abs(a.v - b.v) <= 1;
 }
 
 template<typename T, size_t fraction>
 constexpr inline bool same_up_to_n_bits(fixed<T, fraction> a, fixed<T, fraction> b, int n){
-    return std::abs(a.v - b.v) <= (1<<n);
+    using std::abs;
+    return abs(a.v - b.v) <= (T(1)<<n);
 }
 
 template<typename T, size_t fraction>
@@ -324,7 +426,8 @@ inline constexpr std::strong_ordering operator<=>(fixed_construction_helper<S> a
 template<typename T, size_t fraction>
 constexpr inline fixed<T, fraction> abs(fixed<T, fraction> a){
     fixed<T, fraction> result;
-    result.v = std::abs(a.v);
+    using std::abs;
+    result.v = abs(a.v);
     return result;
 }
 
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+//smallest native integer type that holds `bits` bits
+template<size_t bits, bool is_signed>
+using packed_storage_t = std::conditional_t<bits <= 8, std::conditional_t<is_signed, int8_t, uint8_t>,
+                         std::conditional_t<bits <= 16, std::conditional_t<is_signed, int16_t, uint16_t>,
+                                                        std::conditional_t<is_signed, int32_t, uint32_t>>>;
+
+/*
+    array of fixed values with `bits` bits each, stored back to back without gaps.
+    element i occupies bits [i * bits, (i + 1) * bits) of a little endian bit stream.
+
+    every access is a single unaligned 64 bit load (and store for writes) followed by a shift and a mask,
+    the byte buffer is padded so that the load is always in bounds. the bulk functions work on groups of
+    8 elements, which span exactly `bits` bytes, so every shift inside a group is a compile time constant
+    and the compiler can unroll and vectorize them.
+    values that do not fit into `bits` bits saturate when they are stored.
+*/
+template<size_t bits, size_t fraction, bool is_signed = true>
+class packed_fixed_array{
+    static_assert(bits >= 1 and bits <= 32, "packed elements must have between 1 and 32 bits");
+    static_assert(fraction <= bits, "can not have more fractional bits than there are bits in the element");
+    static_assert(not is_signed or bits >= 2, "signed elements need at least 2 bits");
+
+public:
+    using storage_type = packed_storage_t<bits, is_signed>;
+    using value_type = fixed<storage_type, fraction>;
+
+    constexpr static int64_t min_bits = is_signed ? -(int64_t{1} << (bits - 1)) : 0;
+    constexpr static int64_t max_bits = is_signed ? (int64_t{1} << (bits - 1)) - 1 : (int64_t{1} << bits) - 1;
+
+    packed_fixed_array() = default;
+
+    explicit packed_fixed_array(size_t count) : bytes(byte_size_for(count) + padding, 0), count(count){
+    }
+
+    size_t size() const{
+        return count;
+    }
+
+    //number of bytes holding elements, without the padding
+    size_t byte_size() const{
+        return byte_size_for(count);
+    }
+
+    const uint8_t* data() const{
+        return bytes.data();
+    }
+
+    uint8_t* data(){
+        return bytes.data();
+    }
+
+    void resize(size_t new_count){
+        //clear every bit after the last kept element, padding included, so that growing again yields zeros
+        if(new_count < count){
+            size_t bit = new_count * bits;
+            if(bit % 8 != 0) bytes[bit / 8] &= static_cast<uint8_t>((1u << (bit % 8)) - 1);
+            std::fill(bytes.begin() + static_cast<ptrdiff_t>(byte_size_for(new_count)), bytes.end(), uint8_t(0));
+        }
+        bytes.resize(byte_size_for(new_count) + padding, 0);
+        count = new_count;
+    }
+
+    value_type get(size_t i) const{
+        assert(i < count);
+        return fp_from_bits<storage_type, fraction>(extract(load(i * bits / 8), i * bits % 8));
+    }
+
+    value_type operator[](size_t i) const{
+        return get(i);
+    }
+
+    template<typename T>
+    void set(size_t i, fixed<T, fraction> x){
+        assert(i < count);
+        store_bits(i, clamp_bits(x.v));
+    }
+
+    //out[j] = get(first + j), T must hold every value of `bits` bits, a signed T needs a spare bit for unsigned elements
+    template<typename T>
+    void unpack(size_t first, std::span<fixed<T, fraction>> out) const{
+        static_assert(sizeof(T) >= sizeof(storage_type) and std::is_signed_v<T> >= is_signed and
+                      static_cast<size_t>(std::numeric_limits<T>::digits) >= (is_signed ? bits - 1 : bits),
+                      "the unpacked type must be able to hold every packed value");
+        assert(first + out.size() <= count);
+        size_t j = 0;
+        //unaligned head, element by element up to the next group of 8
+        for(; j < out.size() and (first + j) % 8 != 0; j++) out[j].v = static_cast<T>(get(first + j).v);
+        for(; j + 8 <= out.size(); j += 8){
+            const uint8_t* group = bytes.data() + (first + j) / 8 * bits;
+            unpack_group(group, &out[j]);
+        }
+        for(; j < out.size(); j++) out[j].v = static_cast<T>(get(first + j).v);
+    }
+
+    //set(first + j, in[j]) for every j
+    template<typename T>
+    void pack(size_t first, std::span<const fixed<T, fraction>> in){
+        assert(first + in.size() <= count);
+        size_t j = 0;
+        for(; j < in.size() and (first + j) % 8 != 0; j++) set(first + j, in[j]);
+        for(; j + 8 <= in.size(); j += 8){
+            uint8_t* group = bytes.data() + (first + j) / 8 * bits;
+            pack_group(&in[j], group);
+        }
+        for(; j < in.size(); j++) set(first + j, in[j]);
+    }
+
+private:
+    //an element starts at most 7 bits into its first byte and a 64 bit load covers it completely
+    constexpr static size_t padding = 8;
+    constexpr static uint64_t mask = (uint64_t{1} << bits) - 1;
+
+    static size_t byte_size_for(size_t n){
+        return (n * bits + 7) / 8;
+    }
+
+    static uint64_t load_word(const uint8_t* p){
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        if constexpr(std::endian::native == std::endian::big) word = byte_swap(word);
+        return word;
+    }
+
+    static void store_word(uint8_t* p, uint64_t word){
+        if constexpr(std::endian::native == std::endian::big) word = byte_swap(word);
+        std::memcpy(p, &word, sizeof(word));
+    }
+
+    static constexpr uint64_t byte_swap(uint64_t x){
+        uint64_t result = 0;
+        for(int i = 0; i < 8; i++){
+            result = (result << 8) | (x & 0xff);
+            x >>= 8;
+        }
+        return result;
+    }
+
+    uint64_t load(size_t byte) const{
+        return load_word(bytes.data() + byte);
+    }
+
+    //takes the element starting `shift` bits into word and sign extends it
+    static storage_type extract(uint64_t word, size_t shift){
+        uint64_t raw = (word >> shift) & mask;
+        if constexpr(is_signed){
+            //move the sign bit to the top and shift back arithmetically
+            return static_cast<storage_type>(static_cast<int64_t>(raw << (64 - bits)) >> (64 - bits));
+        }
+        else{
+            return static_cast<storage_type>(raw);
+        }
+    }
+
+    template<typename T>
+    static uint64_t clamp_bits(T v){
+        int64_t x = std::clamp<int64_t>(v, min_bits, max_bits);
+        return static_cast<uint64_t>(x) & mask;
+    }
+
+    void store_bits(size_t i, uint64_t raw){
+        size_t byte = i * bits / 8;
+        size_t shift = i * bits % 8;
+        uint64_t word = load(byte);
+        word = (word & ~(mask << shift)) | (raw << shift);
+        store_word(bytes.data() + byte, word);
+    }
+
+    template<typename T>
+    static void unpack_group(const uint8_t* group, fixed<T, fraction>* out){
+        for(size_t k = 0; k < 8; k++){
+            out[k].v = static_cast<T>(extract(load_word(group + k * bits / 8), k * bits % 8));
+        }
+    }
+
+    //a group covers whole bytes, so it is assembled in registers and written without reading back
+    template<typename T>
+    static void pack_group(const fixed<T, fraction>* in, uint8_t* group){
+        std::array<uint8_t, bits + padding> buffer{};
+        for(size_t k = 0; k < 8; k++){
+            uint8_t* p = buffer.data() + k * bits / 8;
+            store_word(p, load_word(p) | (clamp_bits(in[k].v) << (k * bits % 8)));
+        }
+        std::memcpy(group, buffer.data(), bits);
+    }
+
+    std::vector<uint8_t> bytes = std::vector<uint8_t>(padding, 0);
+    size_t count = 0;
+};
+
+}//namespace fixed_point
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fixed_point{
+
+//runs body(begin, end) over [0, count) split into contiguous chunks on `threads` threads
+template<typename F>
+inline void parallel_rows(size_t count, size_t threads, F&& body){
+    threads = std::max<size_t>(1, std::min(threads, count));
+    if(threads == 1){
+        body(size_t{0}, count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    size_t chunk = (count + threads - 1) / threads;
+    for(size_t t = 0; t < threads; t++){
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if(begin >= end) break;
+        pool.emplace_back([&body, begin, end](){ body(begin, end); });
+    }
+    for(auto& th : pool) th.join();
+}
+
+
+namespace detail{
+
+/*
+    splits [0, count) into one contiguous chunk per thread, reduces every chunk with chunk(begin, end)
+    and combines the partial results in chunk order.
+*/
+template<typename A, typename F, typename C>
+inline A parallel_reduce(size_t count, size_t threads, A identity, F&& chunk, C&& combine){
+    threads = std::max<size_t>(1, std::min(threads, count));
+    const size_t size = (count + threads - 1) / threads;
+    std::vector<A> partial(threads, identity);
+    parallel_rows(threads, threads, [&](size_t first, size_t last){
+        for(size_t t = first; t < last; t++) partial[t] = chunk(std::min(count, t * size), std::min(count, (t + 1) * size));
+    });
+    A result = identity;
+    for(const auto& p : partial) result = combine(result, p);
+    return result;
+}
+
+}//namespace detail
+
+
+/*
+    parallel reductions. fixed addition is exact, every thread sums its chunk into a wide integer and
+    the partial sums are added up, so unlike float the result is bit identical for any number of threads.
+    the inner loops are plain integer reductions the compiler vectorizes.
+*/
+
+//exact sum of all values, in the accumulator type, which does not overflow for up to 2^32 values of at most 32 bits
+template<typename T, size_t fraction>
+inline fixed<accumulator_t<T>, fraction> parallel_sum(std::span<const fixed<T, fraction>> data, size_t threads = 1){
+    static_assert(std::is_integral_v<T>, "parallel_sum needs a builtin integer type");
+    using A = accumulator_t<T>;
+    A sum = detail::parallel_reduce(data.size(), threads, A(0), [&](size_t begin, size_t end){
+        A acc = 0;
+        for(size_t i = begin; i < end; i++) acc += A(data[i].v);
+        return acc;
+    }, [](A a, A b){ return a + b; });
+    return fp_from_bits<accumulator_t<T>, fraction>(sum);
+}
+
+/*
+    sum of a[i] * b[i], accumulated exactly like linalg's wide_dot and rounded and saturated once at the end.
+    products of 32 bit values need up to 62 bits each, so their sum is kept in 128 bits.
+*/
+template<typename T, size_t fraction>
+inline fixed<T, fraction> parallel_dot(std::span<const fixed<T, fraction>> a, std::span<const fixed<T, fraction>> b, size_t threads = 1){
+    static_assert(std::is_integral_v<T>, "parallel_dot needs a builtin integer type");
+    assert(a.size() == b.size());
+    using P = accumulator_t<T>;
+    using A = std::conditional_t<sizeof(T) == 4, wide_int<128, std::is_signed_v<T>>, P>;
+    A sum = detail::parallel_reduce(a.size(), threads, A(0), [&](size_t begin, size_t end){
+        A acc = 0;
+        for(size_t i = begin; i < end; i++) acc += A(P(a[i].v) * P(b[i].v));
+        return acc;
+    }, [](A x, A y){ return x + y; });
+    return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(sum, fraction)));
+}
+
+//smallest and largest value, data must not be empty
+template<typename T, size_t fraction>
+inline std::pair<fixed<T, fraction>, fixed<T, fraction>> parallel_minmax(std::span<const fixed<T, fraction>> data, size_t threads = 1){
+    static_assert(std::is_integral_v<T>, "parallel_minmax needs a builtin integer type");
+    assert(not data.empty());
+    using range = std::pair<T, T>;
+    range identity{std::numeric_limits<T>::max(), std::numeric_limits<T>::min()};
+    range result = detail::parallel_reduce(data.size(), threads, identity, [&](size_t begin, size_t end){
+        T lowest = identity.first;
+        T highest = identity.second;
+        for(size_t i = begin; i < end; i++){
+            lowest = std::min(lowest, data[i].v);
+            highest = std::max(highest, data[i].v);
+        }
+        return range{lowest, highest};
+    }, [](range x, range y){ return range{std::min(x.first, y.first), std::max(x.second, y.second)}; });
+    return {fp_from_bits<T, fraction>(result.first), fp_from_bits<T, fraction>(result.second)};
+}
+
+/*
+    euclidean norm, the sum of squares carries 2*fraction fractional bits, so its integer square root is already in the right format.
+    a single square of a 32 bit value needs 62 bits, so the sum of squares is only kept in 64 bits for types of up to 16 bits
+    and in 128 or 256 bits otherwise. it can not wrap and a norm beyond the range of T saturates.
+*/
+template<typename T, size_t fraction>
+inline fixed<T, fraction> parallel_norm(std::span<const fixed<T, fraction>> data, size_t threads = 1){
+    static_assert(std::is_integral_v<T>, "parallel_norm needs a builtin integer type");
+    using A = std::conditional_t<sizeof(T) <= 2, uint64_t, std::conditional_t<sizeof(T) <= 4, wide_uint<128>, wide_uint<256>>>;
+    using P = product_t<T>;
+    auto square = [](T v){
+        if constexpr(std::is_integral_v<P>) return A(static_cast<std::make_unsigned_t<P>>(P(v) * P(v)));
+        else return A(P(v) * P(v));
+    };
+    A sum = detail::parallel_reduce(data.size(), threads, A(0), [&](size_t begin, size_t end){
+        A acc = 0;
+        for(size_t i = begin; i < end; i++) acc += square(data[i].v);
+        return acc;
+    }, [](A x, A y){ return x + y; });
+    return fp_from_bits<T, fraction>(saturate<T>(rounded_integer_sqrt(sum)));
+}
+
+}//namespace fixed_point
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_sort.hpp"
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fixed_point{
+
+namespace detail{
+
+/*
+    coefficients and intermediate results of polynomial evaluation are Q32 in an int64,
+    which covers the whole range of every fixed type of at most 32 bits.
+*/
+constexpr inline size_t polynomial_fraction = 32;
+
+/*
+    (a * b >> shift rounded) + c, with the exact 128 bit product and sum in between.
+    intermediates beyond the range of int64 saturate instead of wrapping, so they saturate the result as well.
+*/
+constexpr inline int64_t multiply_shift_add(int64_t a, int64_t b, size_t shift, int64_t c = 0){
+    return saturate<int64_t>(rounding_shift_right(wide_product(a, b), shift) + wide_int<128>(c));
+}
+
+//a Q32 intermediate rounded to the given fraction of T, the rounding is done wide, so a saturated intermediate can not wrap
+template<typename T>
+constexpr inline T polynomial_result(int64_t acc, size_t fraction){
+    return saturate<T>(rounding_shift_right(wide_int<128>(acc), polynomial_fraction - fraction));
+}
+
+//whether c is inside the range of Q32 in an int64, [-2^31, 2^31). fixed coefficients are checked by their conversion
+template<typename C>
+constexpr inline bool fits_polynomial_coefficient(C c){
+    if constexpr(std::is_floating_point_v<C>) return c >= -2147483648.0 and c < 2147483648.0;
+    else return true;
+}
+
+//a coefficient given as _fixp_t literal, fixed value of any format or double, in Q32. doubles out of range saturate
+template<typename C>
+constexpr inline int64_t polynomial_coefficient(C c){
+    if constexpr(std::is_floating_point_v<C>){
+        if(not fits_polynomial_coefficient(c)) return c < 0 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+        return static_cast<int64_t>(c * 4294967296.0 + (c < 0 ? -0.5 : 0.5));
+    }
+    else if constexpr(C::frac_bits() <= polynomial_fraction){
+        return static_cast<int64_t>(c.v) << (polynomial_fraction - C::frac_bits());
+    }
+    else{
+        return rounding_shift_right(static_cast<int64_t>(c.v), C::frac_bits() - polynomial_fraction);
+    }
+}
+
+template<size_t S>
+constexpr inline int64_t polynomial_coefficient(fixed_construction_helper<S> c){
+    return fixed<int64_t, polynomial_fraction>(c).v;
+}
+
+}//namespace detail
+
+
+/*
+    polynomial c0 + c1 x + c2 x^2 + ... with coefficients fixed at compile time, e.g.
+    fixed_polynomial<fixed<int32_t, 16>, 1.0_fixp_t, -0.5_fixp_t, 0.125_fixp_t>.
+    coefficients may be _fixp_t literals, fixed values or doubles and are stored in Q32 independent of fixed_t,
+    all intermediates are Q32 as well and only the result is rounded to fixed_t, instead of rounding to
+    the fraction of fixed_t after every step like a chain of operator* does.
+*/
+template<typename fixed_t, auto... coefficients>
+class fixed_polynomial{
+    using T = typename fixed_t::int_type;
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "fixed_polynomial needs a builtin integer type of at most 32 bits");
+    static_assert(sizeof...(coefficients) > 0, "needs at least one coefficient");
+    static_assert((detail::fits_polynomial_coefficient(coefficients) and ...),
+                  "coefficients must be below 2^31 in magnitude");
+    constexpr static size_t fraction = fixed_t::frac_bits();
+    constexpr static size_t q = detail::polynomial_fraction;
+
+public:
+    constexpr static size_t degree = sizeof...(coefficients) - 1;
+
+    constexpr static std::array<int64_t, degree + 1> q32_coefficients = {detail::polynomial_coefficient(coefficients)...};
+
+    //horner's scheme, degree dependent multiplies
+    constexpr static fixed_t horner(fixed_t x){
+        int64_t acc = q32_coefficients[degree];
+        for(size_t i = degree; i > 0; i--) acc = detail::multiply_shift_add(acc, x.v, fraction, q32_coefficients[i - 1]);
+        return to_fixed(acc);
+    }
+
+    /*
+        estrin's scheme, pairs c_2i + c_2i+1 x and combines them with x^2, x^4, ...
+        it needs a few more multiplies than horner, but they are independent of each other,
+        so for higher degrees the dependency chain is log2(degree) multiplies long instead of degree.
+    */
+    constexpr static fixed_t estrin(fixed_t x){
+        std::array<int64_t, degree + 1> level = q32_coefficients;
+        int64_t power = detail::multiply_shift_add(x.v, int64_t{1} << (q - fraction), 0);
+        size_t count = degree + 1;
+        while(count > 1){
+            size_t pairs = count / 2;
+            for(size_t i = 0; i < pairs; i++) level[i] = detail::multiply_shift_add(level[2 * i + 1], power, q, level[2 * i]);
+            if(count % 2 == 1) level[pairs] = level[count - 1];
+            count = (count + 1) / 2;
+            if(count > 1) power = detail::multiply_shift_add(power, power, q);
+        }
+        return to_fixed(level[0]);
+    }
+
+    constexpr fixed_t operator()(fixed_t x) const{
+        return horner(x);
+    }
+
+    //evaluates the polynomial for every element of in
+    static void evaluate(std::span<const fixed_t> in, std::span<fixed_t> out){
+        assert(out.size() >= in.size());
+        for(size_t i = 0; i < in.size(); i++) out[i] = horner(in[i]);
+    }
+
+private:
+    constexpr static fixed_t to_fixed(int64_t acc){
+        return fp_from_bits<T, fraction>(detail::polynomial_result<T>(acc, fraction));
+    }
+};
+
+
+namespace detail{
+
+template<typename fixed_t, auto coefficients, typename = std::make_index_sequence<coefficients.size()>>
+struct polynomial_from_array;
+
+template<typename fixed_t, auto coefficients, size_t... i>
+struct polynomial_from_array<fixed_t, coefficients, std::index_sequence<i...>>{
+    using type = fixed_polynomial<fixed_t, coefficients[i]...>;
+};
+
+}//namespace detail
+
+//fixed_polynomial with the coefficients of a constexpr std::array, e.g. the result of fit_polynomial
+template<typename fixed_t, auto coefficients>
+using polynomial_from_array_t = typename detail::polynomial_from_array<fixed_t, coefficients>::type;
+
+
+/*
+    least squares fit of a polynomial of the given degree to f on [lo, hi], computed at compile time.
+    f must be usable in constant expressions. the fit is done in u = (2x - lo - hi) / (hi - lo) on [-1, 1],
+    where the normal equations are well conditioned for moderate degrees, and then expanded to powers of x.
+    returns the coefficients c0 ... c_degree as doubles, to be used as template arguments of fixed_polynomial.
+*/
+template<size_t degree, typename F>
+consteval inline std::array<double, degree + 1> fit_polynomial(F f, double lo, double hi){
+    static_assert(degree <= 12, "higher degrees are not well conditioned");
+    constexpr size_t n = degree + 1;
+    constexpr size_t samples = 64 * n;
+
+    //normal equations A^T A c = A^T y
+    std::array<std::array<double, n + 1>, n> system{};
+    for(size_t s = 0; s < samples; s++){
+        double u = -1.0 + 2.0 * static_cast<double>(s) / static_cast<double>(samples - 1);
+        double x = 0.5 * (hi - lo) * u + 0.5 * (hi + lo);
+        std::array<double, n> powers{};
+        powers[0] = 1.0;
+        for(size_t k = 1; k < n; k++) powers[k] = powers[k - 1] * u;
+        double y = f(x);
+        for(size_t r = 0; r < n; r++){
+            for(size_t c = 0; c < n; c++) system[r][c] += powers[r] * powers[c];
+            system[r][n] += powers[r] * y;
+        }
+    }
+
+    //gaussian elimination with partial pivoting
+    for(size_t col = 0; col < n; col++){
+        size_t pivot = col;
+        for(size_t r = col + 1; r < n; r++){
+            double a = system[r][col] < 0 ? -system[r][col] : system[r][col];
+            double b = system[pivot][col] < 0 ? -system[pivot][col] : system[pivot][col];
+            if(a > b) pivot = r;
+        }
+        std::swap(system[col], system[pivot]);
+        for(size_t r = col + 1; r < n; r++){
+            double factor = system[r][col] / system[col][col];
+            for(size_t c = col; c <= n; c++) system[r][c] -= factor * system[col][c];
+        }
+    }
+    std::array<double, n> in_u{};
+    for(size_t r = n; r-- > 0;){
+        double sum = system[r][n];
+        for(size_t c = r + 1; c < n; c++) sum -= system[r][c] * in_u[c];
+        in_u[r] = sum / system[r][r];
+    }
+
+    //u = scale x + offset, expand sum in_u[k] (scale x + offset)^k into powers of x
+    double scale = 2.0 / (hi - lo);
+    double offset = -(hi + lo) / (hi - lo);
+    std::array<double, n> result{};
+    std::array<double, n> basis{};
+    basis[0] = 1.0;
+    for(size_t k = 0; k < n; k++){
+        for(size_t j = 0; j <= k; j++) result[j] += in_u[k] * basis[j];
+        if(k + 1 == n) break;
+        //basis *= scale x + offset
+        for(size_t j = k + 1; j > 0; j--) basis[j] = basis[j] * offset + basis[j - 1] * scale;
+        basis[0] *= offset;
+    }
+    return result;
+}
+
+
+/*
+    natural cubic spline through the knots (x_i, y_i).
+    the segment polynomials are computed once in double and stored in Q32, evaluation is integer only and
+    rounds once like fixed_polynomial. the segment of x is found by binary search, or by a single division
+    when the knots are equally spaced. x outside the knots is clamped to the first or last knot.
+    segment coefficients beyond the Q32 range saturate, so segments steeper than 2^31 lose accuracy
+    but still give a saturated result.
+*/
+template<typename T, size_t fraction>
+class cubic_spline{
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "cubic_spline needs a builtin integer type of at most 32 bits");
+
+public:
+    using value_type = fixed<T, fraction>;
+
+    cubic_spline(std::span<const value_type> xs, std::span<const value_type> ys) : knots(xs.begin(), xs.end()){
+        assert(xs.size() == ys.size() and xs.size() >= 2);
+        const size_t n = xs.size();
+        const double unit = static_cast<double>(uint64_t{1} << fraction);
+        std::vector<double> x(n);
+        std::vector<double> y(n);
+        for(size_t i = 0; i < n; i++){
+            assert(i == 0 or xs[i - 1] < xs[i]);
+            x[i] = static_cast<double>(xs[i].v) / unit;
+            y[i] = static_cast<double>(ys[i].v) / unit;
+        }
+
+        //second derivatives with m_0 = m_n-1 = 0, thomas algorithm on the tridiagonal system
+        std::vector<double> m(n, 0.0);
+        std::vector<double> c(n, 0.0);
+        std::vector<double> d(n, 0.0);
+        for(size_t i = 1; i + 1 < n; i++){
+            double h0 = x[i] - x[i - 1];
+            double h1 = x[i + 1] - x[i];
+            double diagonal = 2.0 * (h0 + h1) - h0 * c[i - 1];
+            c[i] = h1 / diagonal;
+            d[i] = (6.0 * ((y[i + 1] - y[i]) / h1 - (y[i] - y[i - 1]) / h0) - h0 * d[i - 1]) / diagonal;
+        }
+        for(size_t i = n - 1; i-- > 1;) m[i] = d[i] - c[i] * m[i + 1];
+
+        segments.resize(n - 1);
+        for(size_t i = 0; i + 1 < n; i++){
+            double h = x[i + 1] - x[i];
+            double b = (y[i + 1] - y[i]) / h - h * (2.0 * m[i] + m[i + 1]) / 6.0;
+            segments[i] = {detail::polynomial_coefficient(y[i]), detail::polynomial_coefficient(b),
+                           detail::polynomial_coefficient(m[i] / 2.0), detail::polynomial_coefficient((m[i + 1] - m[i]) / (6.0 * h))};
+        }
+
+        step = static_cast<int64_t>(knots[1].v) - static_cast<int64_t>(knots[0].v);
+        uniform = true;
+        for(size_t i = 1; i + 1 < n; i++){
+            uniform &= static_cast<int64_t>(knots[i + 1].v) - static_cast<int64_t>(knots[i].v) == step;
+        }
+    }
+
+    bool uniform_knots() const{
+        return uniform;
+    }
+
+    size_t segment_count() const{
+        return segments.size();
+    }
+
+    //index of the segment holding x, x is already clamped to the knots
+    size_t segment_of(value_type x) const{
+        size_t i;
+        if(uniform){
+            i = static_cast<size_t>((static_cast<int64_t>(x.v) - static_cast<int64_t>(knots.front().v)) / step);
+        }
+        else{
+            i = upper_bound(std::span<const value_type>(knots), x);
+            i = i == 0 ? 0 : i - 1;
+        }
+        return std::min(i, segments.size() - 1);
+    }
+
+    value_type operator()(value_type x) const{
+        x = clamp(x, knots.front(), knots.back());
+        return evaluate_segment(segment_of(x), x);
+    }
+
+    void evaluate(std::span<const value_type> in, std::span<value_type> out) const{
+        assert(out.size() >= in.size());
+        for(size_t i = 0; i < in.size(); i++) out[i] = (*this)(in[i]);
+    }
+
+private:
+    value_type evaluate_segment(size_t i, value_type x) const{
+        const auto& s = segments[i];
+        int64_t dx = static_cast<int64_t>(x.v) - static_cast<int64_t>(knots[i].v);
+        int64_t acc = s[3];
+        for(size_t k = 3; k > 0; k--) acc = detail::multiply_shift_add(acc, dx, fraction, s[k - 1]);
+        return fp_from_bits<T, fraction>(detail::polynomial_result<T>(acc, fraction));
+    }
+
+    std::vector<value_type> knots;
+    //a + b dx + c dx^2 + d dx^3 in Q32, dx measured from the segment's first knot
+    std::vector<std::array<int64_t, 4>> segments;
+    int64_t step = 0;
+    bool uniform = false;
+};
+
+}//namespace fixed_point
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <fmt/core.h>
+
+namespace fixed_point{
+
+//number of fractional bits which represent d exactly, 0 for integers
+inline size_t fractional_bits_needed(double d){
+    if(d == 0.0 or not std::isfinite(d)) return 0;
+    int exponent;
+    double m = std::frexp(std::abs(d), &exponent); //|d| = m * 2^exponent with m in [0.5, 1)
+    auto mantissa = static_cast<uint64_t>(std::ldexp(m, std::numeric_limits<double>::digits));
+    int bits = std::numeric_limits<double>::digits - exponent - std::countr_zero(mantissa);
+    return bits > 0 ? static_cast<size_t>(bits) : 0;
+}
+
+struct range_record{
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double smallest_magnitude = std::numeric_limits<double>::infinity(); //smallest non zero absolute value
+    size_t finest_fraction = 0; //most fractional bits any recorded value needs, at most max_fraction
+    size_t max_fraction = 64; //bits finer than the profiled type holds are rounding noise of the double computation
+    double resolution = 0.0; //absolute precision the variable needs, 0 derives it from finest_fraction
+    uint64_t samples = 0;
+
+    void record(double d){
+        min = std::min(min, d);
+        max = std::max(max, d);
+        if(d != 0.0) smallest_magnitude = std::min(smallest_magnitude, std::abs(d));
+        finest_fraction = std::max(finest_fraction, std::min(fractional_bits_needed(d), max_fraction));
+        samples++;
+    }
+};
+
+struct fixed_recommendation{
+    size_t int_bits; //8, 16, 32 or 64
+    bool is_signed;
+    size_t fraction;
+    bool fits; //false if even 64 bits can not hold both the range and the requested resolution
+};
+
+inline constexpr std::string_view int_type_name(size_t bits, bool is_signed){
+    switch(bits){
+        case 8:  return is_signed ? "int8_t"  : "uint8_t";
+        case 16: return is_signed ? "int16_t" : "uint16_t";
+        case 32: return is_signed ? "int32_t" : "uint32_t";
+        default: return is_signed ? "int64_t" : "uint64_t";
+    }
+}
+
+/*
+    picks the narrowest integer type which holds [min, max] with at least `resolution` precision,
+    then hands every remaining bit to the fractional part.
+    without a requested resolution the finest fractional bit of any recorded value is kept, so every recorded value stays exact.
+    whole bits w are chosen such that max < 2^w and -2^w <= min, same as fixed::whole_bits()
+*/
+inline fixed_recommendation recommend(const range_record& r){
+    fixed_recommendation result{64, false, 0, false};
+    if(r.samples == 0) return result;
+
+    result.is_signed = r.min < 0.0;
+    size_t whole = 0;
+    if(r.max >= 1.0){
+        whole = static_cast<size_t>(std::floor(std::log2(r.max))) + 1;
+    }
+    if(r.min < -1.0){
+        whole = std::max(whole, static_cast<size_t>(std::ceil(std::log2(-r.min))));
+    }
+    size_t frac = r.finest_fraction;
+    if(r.resolution > 0.0){
+        frac = r.resolution < 1.0 ? static_cast<size_t>(std::ceil(-std::log2(r.resolution))) : 0;
+    }
+    size_t needed = whole + frac + (result.is_signed ? 1 : 0);
+    for(size_t bits : {8, 16, 32, 64}){
+        if(needed <= bits){
+            result.int_bits = bits;
+            result.fits = true;
+            break;
+        }
+    }
+    size_t available = result.int_bits - (result.is_signed ? 1 : 0);
+    result.fraction = available > whole ? available - whole : 0;
+    return result;
+}
+
+//note: not thread safe, profile a single threaded representative run
+class range_profiler{
+    std::map<std::string, range_record, std::less<>> records;
+
+public:
+    range_record& variable(std::string_view name, double resolution = 0.0){
+        auto it = records.find(name);
+        if(it == records.end()){
+            it = records.emplace(std::string(name), range_record{}).first;
+            it->second.resolution = resolution;
+        }
+        return it->second;
+    }
+
+    const std::map<std::string, range_record, std::less<>>& variables() const{
+        return records;
+    }
+
+    void clear(){
+        records.clear();
+    }
+
+    void report() const{
+        for(const auto& [name, r] : records){
+            if(r.samples == 0){
+                fmt::print("{}: no samples recorded\n", name);
+                continue;
+            }
+            auto rec = recommend(r);
+            fmt::print("{}: min: {:.12g} max: {:.12g} smallest magnitude: {:.6g} samples: {} -> fixed<{}, {}>{}\n",
+                       name, r.min, r.max, r.smallest_magnitude, r.samples,
+                       int_type_name(rec.int_bits, rec.is_signed), rec.fraction,
+                       rec.fits ? "" : " (does not fit, precision will be lost)");
+            if(rec.fits and std::ldexp(r.smallest_magnitude, static_cast<int>(rec.fraction)) < 1.0){
+                fmt::print("    warning: smallest magnitude flushes to zero at {} fractional bits\n", rec.fraction);
+            }
+        }
+    }
+};
+
+inline range_profiler& default_range_profiler(){
+    static range_profiler profiler;
+    return profiler;
+}
+
+
+/*
+    drop in replacement for fixed<T, fraction> which computes in double precision.
+    named variables report every value assigned to them to a range_profiler,
+    temporaries are not recorded.
+*/
+template<typename T, size_t fraction>
+struct profiling_fixed{
+    using int_type = T;
+    using fixed_type = fixed<T, fraction>;
+
+    double d = 0.0;
+    range_record* record = nullptr;
+
+    constexpr profiling_fixed() = default;
+
+    constexpr profiling_fixed(const profiling_fixed& other) : d(other.d){
+    }
+
+    profiling_fixed(std::string_view name, range_profiler& profiler = default_range_profiler()){
+        track(name, profiler);
+    }
+
+    profiling_fixed(std::string_view name, profiling_fixed init, range_profiler& profiler = default_range_profiler()){
+        track(name, profiler);
+        *this = init;
+    }
+
+    profiling_fixed& operator=(const profiling_fixed& other){
+        d = other.d;
+        if(record) record->record(d);
+        return *this;
+    }
+
+    constexpr profiling_fixed(int_type i) : d(static_cast<double>(i)){
+    }
+
+    template<size_t S>
+    profiling_fixed(fixed_construction_helper<S> helper){
+        d = static_cast<double>(helper.whole) + std::ldexp(static_cast<double>(helper.frac), -64);
+        if(helper.negative) d = -d;
+    }
+
+    profiling_fixed(fixed_type f){
+        d = std::ldexp(static_cast<double>(f.v), -static_cast<int>(fraction));
+    }
+
+    profiling_fixed& operator=(int i){
+        return *this = profiling_fixed(static_cast<int_type>(i));
+    }
+
+    //the precision the variable needs is derived from the values assigned to it, up to the fraction of this type
+    void track(std::string_view name, range_profiler& profiler = default_range_profiler()){
+        record = &profiler.variable(name);
+        record->max_fraction = fraction;
+    }
+
+    //records assignments for a variable which needs an absolute precision of `resolution`
+    void track(std::string_view name, double resolution, range_profiler& profiler = default_range_profiler()){
+        record = &profiler.variable(name, resolution);
+        record->max_fraction = fraction;
+    }
+
+    //the value the profiled variable would hold as fixed<T, fraction>
+    fixed_type to_fixed() const{
+        fixed_type result;
+        result.v = static_cast<int_type>(std::llround(std::ldexp(d, static_cast<int>(fraction))));
+        return result;
+    }
+
+    template<typename S, size_t new_frac_bits>
+    explicit constexpr operator profiling_fixed<S, new_frac_bits>() const{
+        profiling_fixed<S, new_frac_bits> result;
+        result.d = d;
+        return result;
+    }
+
+    constexpr static size_t frac_bits(){
+        return fixed_type::frac_bits();
+    }
+
+    constexpr static size_t whole_bits(){
+        return fixed_type::whole_bits();
+    }
+
+    constexpr static bool is_signed(){
+        return fixed_type::is_signed();
+    }
+
+    int_type to_int() const{
+        return static_cast<int_type>(std::floor(d));
+    }
+
+    int_type whole_part() const{
+        return to_fixed().whole_part();
+    }
+
+    int_type frac_part() const{
+        return to_fixed().frac_part();
+    }
+
+    std::array<char, fixed_type::string_size()> to_string() const{
+        return to_fixed().to_string();
+    }
+};
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> make_profiling(double d){
+    profiling_fixed<T, fraction> result;
+    result.d = d;
+    return result;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> operator+(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return make_profiling<T, fraction>(a.d + b.d);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator+(profiling_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a + profiling_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator+(fixed_construction_helper<S> a, profiling_fixed<T, fraction> b){
+    return profiling_fixed<T, fraction>(a) + b;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> operator-(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return make_profiling<T, fraction>(a.d - b.d);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator-(profiling_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a - profiling_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator-(fixed_construction_helper<S> a, profiling_fixed<T, fraction> b){
+    return profiling_fixed<T, fraction>(a) - b;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> operator-(profiling_fixed<T, fraction> a){
+    return make_profiling<T, fraction>(-a.d);
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> operator*(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return make_profiling<T, fraction>(a.d * b.d);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator*(profiling_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a * profiling_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator*(fixed_construction_helper<S> a, profiling_fixed<T, fraction> b){
+    return profiling_fixed<T, fraction>(a) * b;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> operator/(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return make_profiling<T, fraction>(a.d / b.d);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator/(profiling_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a / profiling_fixed<T, fraction>(b);
+}
+
+template<typename T, size_t fraction, size_t S>
+inline profiling_fixed<T, fraction> operator/(fixed_construction_helper<S> a, profiling_fixed<T, fraction> b){
+    return profiling_fixed<T, fraction>(a) / b;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> correctly_rounded_division(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return a / b;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> fast_division(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return a / b;
+}
+
+template<typename T, size_t fraction, typename U>
+inline profiling_fixed<T, fraction>& operator+=(profiling_fixed<T, fraction>& a, U b){
+    a = a + b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline profiling_fixed<T, fraction>& operator-=(profiling_fixed<T, fraction>& a, U b){
+    a = a - b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline profiling_fixed<T, fraction>& operator*=(profiling_fixed<T, fraction>& a, U b){
+    a = a * b;
+    return a;
+}
+
+template<typename T, size_t fraction, typename U>
+inline profiling_fixed<T, fraction>& operator/=(profiling_fixed<T, fraction>& a, U b){
+    a = a / b;
+    return a;
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> sqrt(profiling_fixed<T, fraction> x){
+    return make_profiling<T, fraction>(std::sqrt(x.d));
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> abs(profiling_fixed<T, fraction> a){
+    return make_profiling<T, fraction>(std::abs(a.d));
+}
+
+template<typename T, size_t fraction>
+inline profiling_fixed<T, fraction> clamp(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b, profiling_fixed<T, fraction> c){
+    if(a < b) return b;
+    if(a > c) return c;
+    return a;
+}
+
+template<typename T, size_t fraction>
+inline bool operator==(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return a.d == b.d;
+}
+
+template<typename T, size_t fraction>
+inline std::partial_ordering operator<=>(profiling_fixed<T, fraction> a, profiling_fixed<T, fraction> b){
+    return a.d <=> b.d;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline std::partial_ordering operator<=>(profiling_fixed<T, fraction> a, fixed_construction_helper<S> b){
+    return a.d <=> profiling_fixed<T, fraction>(b).d;
+}
+
+template<typename T, size_t fraction, size_t S>
+inline std::partial_ordering operator<=>(fixed_construction_helper<S> a, profiling_fixed<T, fraction> b){
+    return profiling_fixed<T, fraction>(a).d <=> b.d;
+}
+
+}//namespace fixed_point
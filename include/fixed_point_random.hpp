@@ -0,0 +1,365 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_parallel.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <span>
+
+namespace fixed_point{
+
+//xoshiro256** by blackman and vigna, a fast 64 bit generator with 256 bits of state
+class xoshiro256ss{
+public:
+    using result_type = uint64_t;
+
+    //the state is filled from the seed with splitmix64, so any seed gives a good state
+    constexpr explicit xoshiro256ss(uint64_t seed = 0){
+        for(auto& s : state){
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    constexpr static result_type min(){
+        return 0;
+    }
+
+    constexpr static result_type max(){
+        return ~uint64_t{0};
+    }
+
+    constexpr result_type operator()(){
+        uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = std::rotl(state[3], 45);
+        return result;
+    }
+
+    //advances by 2^128 steps, gives non overlapping sequences for parallel streams
+    constexpr void jump(){
+        constexpr std::array<uint64_t, 4> polynomial = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        std::array<uint64_t, 4> result{};
+        for(uint64_t word : polynomial){
+            for(int b = 0; b < 64; b++){
+                if((word >> b) & 1){
+                    for(size_t i = 0; i < 4; i++) result[i] ^= state[i];
+                }
+                (*this)();
+            }
+        }
+        state = result;
+    }
+
+private:
+    std::array<uint64_t, 4> state;
+};
+
+
+/*
+    philox 4x32 with 10 rounds by salmon et al., a counter based generator: the output is a bijective
+    function of a 128 bit counter and a 64 bit key, so any element of the sequence can be computed
+    independently of all others.
+*/
+constexpr inline std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key){
+    constexpr uint64_t m0 = 0xd2511f53;
+    constexpr uint64_t m1 = 0xcd9e8d57;
+    for(int round = 0; round < 10; round++){
+        uint64_t p0 = m0 * counter[0];
+        uint64_t p1 = m1 * counter[2];
+        counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0)};
+        key[0] += 0x9e3779b9;
+        key[1] += 0xbb67ae85;
+    }
+    return counter;
+}
+
+/*
+    the random stream of one element of a bulk fill: element `index` of `seed` draws block after block
+    of philox output for the counter (index, block). it depends on nothing but seed and index,
+    so a fill gives the same values no matter how it is split over threads.
+*/
+class philox_stream{
+public:
+    using result_type = uint64_t;
+
+    constexpr philox_stream(uint64_t seed, uint64_t index)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, index(index){
+    }
+
+    constexpr static result_type min(){
+        return 0;
+    }
+
+    constexpr static result_type max(){
+        return ~uint64_t{0};
+    }
+
+    constexpr result_type operator()(){
+        if(used == 2){
+            std::array<uint32_t, 4> counter = {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+                                               static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32)};
+            buffer = philox4x32(counter, key);
+            block++;
+            used = 0;
+        }
+        uint64_t result = (static_cast<uint64_t>(buffer[2 * used + 1]) << 32) | buffer[2 * used];
+        used++;
+        return result;
+    }
+
+private:
+    std::array<uint32_t, 2> key;
+    uint64_t index;
+    uint64_t block = 0;
+    std::array<uint32_t, 4> buffer{};
+    size_t used = 2;
+};
+
+
+//uniform in [0, 1) with every one of the 2^fraction values equally likely, the top bits of one draw are the fraction
+template<typename T, size_t fraction, typename G>
+constexpr inline fixed<T, fraction> uniform01(G& gen){
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 8, "needs a builtin integer type");
+    static_assert(fraction > 0 and fraction < sizeof(T) * 8 + (std::is_signed_v<T> ? 0 : 1), "1.0 must be above the largest value");
+    uint64_t bits = gen();
+    return fp_from_bits<T, fraction>(static_cast<T>(bits >> (64 - fraction)));
+}
+
+/*
+    uniform in [lo, hi), unbiased. uses lemire's multiply and reject method: the high half of draw * range
+    is the result, and the rare low halves below 2^64 mod range, which would favour some results, are redrawn.
+*/
+template<typename T, size_t fraction, typename G>
+constexpr inline fixed<T, fraction> uniform(G& gen, fixed<T, fraction> lo, fixed<T, fraction> hi){
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 8, "needs a builtin integer type");
+    assert(lo < hi);
+    using U = std::make_unsigned_t<T>;
+    uint64_t range = static_cast<U>(static_cast<U>(hi.v) - static_cast<U>(lo.v));
+    uint64_t high;
+    uint64_t low = detail::multiply_limbs(gen(), range, high);
+    if(low < range){
+        uint64_t threshold = (0 - range) % range;
+        while(low < threshold) low = detail::multiply_limbs(gen(), range, high);
+    }
+    return fp_from_bits<T, fraction>(static_cast<T>(static_cast<U>(static_cast<U>(lo.v) + static_cast<U>(high))));
+}
+
+
+//constexpr versions of the functions the ziggurat tables need, accurate to a few ulp
+constexpr inline double constexpr_exp(double x){
+    //e^x = 2^k e^r with |r| <= ln(2) / 2
+    constexpr double ln2 = 0.69314718055994530942;
+    int k = static_cast<int>(x / ln2 + (x >= 0 ? 0.5 : -0.5));
+    double r = x - k * ln2;
+    double term = 1.0;
+    double result = 1.0;
+    for(int i = 1; i < 20; i++){
+        term *= r / i;
+        result += term;
+    }
+    for(; k > 0; k--) result *= 2.0;
+    for(; k < 0; k++) result /= 2.0;
+    return result;
+}
+
+constexpr inline double constexpr_log(double x){
+    //x = 2^k m with m in [1, 2), log(m) = 2 atanh((m - 1) / (m + 1))
+    constexpr double ln2 = 0.69314718055994530942;
+    int k = 0;
+    while(x >= 2.0){
+        x /= 2.0;
+        k++;
+    }
+    while(x < 1.0){
+        x *= 2.0;
+        k--;
+    }
+    double s = (x - 1.0) / (x + 1.0);
+    double s2 = s * s;
+    double term = s;
+    double result = 0.0;
+    for(int i = 1; i < 60; i += 2){
+        result += term / i;
+        term *= s2;
+    }
+    return 2.0 * result + k * ln2;
+}
+
+constexpr inline double constexpr_sqrt(double x){
+    if(x <= 0.0) return 0.0;
+    double y = x > 1.0 ? x : 1.0;
+    for(int i = 0; i < 100; i++){
+        double next = 0.5 * (y + x / y);
+        if(next == y) break;
+        y = next;
+    }
+    return y;
+}
+
+
+namespace detail{
+
+//start of the tail of marsaglia and tsang's 128 layer ziggurat
+constexpr inline double ziggurat_r = 3.442619855899;
+
+//a 57 bit draw in units of 2^-56 times width[i] in Q28 is shifted right by 25 to give the value in Q59
+constexpr inline int ziggurat_width_fraction = 59;
+
+struct ziggurat_table{
+    std::array<uint32_t, 128> threshold{};
+    std::array<uint64_t, 128> width{};
+    std::array<double, 128> density{};
+};
+
+constexpr inline ziggurat_table make_ziggurat_table(){
+    constexpr double area = 9.91256303526217e-3;
+    constexpr double m1 = 2147483648.0;
+    constexpr double q_scale = static_cast<double>(uint64_t{1} << (ziggurat_width_fraction - 31));
+    ziggurat_table t;
+    double dn = ziggurat_r;
+    double tn = ziggurat_r;
+    double q = area / constexpr_exp(-0.5 * dn * dn);
+    t.threshold[0] = static_cast<uint32_t>((dn / q) * m1);
+    t.threshold[1] = 0;
+    t.width[0] = static_cast<uint64_t>(q * q_scale + 0.5);
+    t.width[127] = static_cast<uint64_t>(dn * q_scale + 0.5);
+    t.density[0] = 1.0;
+    t.density[127] = constexpr_exp(-0.5 * dn * dn);
+    for(size_t i = 126; i >= 1; i--){
+        dn = constexpr_sqrt(-2.0 * constexpr_log(area / dn + constexpr_exp(-0.5 * dn * dn)));
+        t.threshold[i + 1] = static_cast<uint32_t>((dn / tn) * m1);
+        tn = dn;
+        t.density[i] = constexpr_exp(-0.5 * dn * dn);
+        t.width[i] = static_cast<uint64_t>(dn * q_scale + 0.5);
+    }
+    return t;
+}
+
+constexpr inline ziggurat_table ziggurat_tables = make_ziggurat_table();
+
+}//namespace detail
+
+
+/*
+    standard normal variates with marsaglia and tsang's ziggurat over 128 layers.
+    the tables are computed at compile time. in about 99% of the draws the sample lies inside its layer's
+    rectangle and is produced with one integer multiply, the value never passes through a float.
+    the layer is taken from the top 7 bits of a draw and the signed value from the other 57, unlike the original
+    code which took both from the same 32 bits and correlated the layer with the value.
+    only the wedges and the tail fall back to exp and log.
+*/
+class normal_ziggurat{
+public:
+    constexpr static double r = detail::ziggurat_r;
+    constexpr static int width_fraction = detail::ziggurat_width_fraction;
+
+    template<typename T, size_t fraction, typename G>
+    static fixed<T, fraction> sample(G& gen){
+        static_assert(std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) <= 8, "needs a signed builtin integer type");
+        static_assert(fraction <= static_cast<size_t>(width_fraction), "at most 59 fractional bits");
+        const auto& table = detail::ziggurat_tables;
+        for(;;){
+            uint64_t bits = gen();
+            size_t iz = static_cast<size_t>(bits >> 57);
+            int64_t hz = static_cast<int64_t>(bits << 7) >> 7;
+            uint64_t magnitude = static_cast<uint64_t>(hz < 0 ? -hz : hz);
+            uint64_t high;
+            uint64_t low = detail::multiply_limbs(magnitude, table.width[iz], high);
+            int64_t scaled = static_cast<int64_t>((high << 39) | (low >> 25));
+            int64_t value = hz < 0 ? -scaled : scaled;
+            //thresholds are in units of 2^-31
+            if(magnitude < static_cast<uint64_t>(table.threshold[iz]) << 25){
+                return to_fixed<T, fraction>(value);
+            }
+
+            if(iz == 0){
+                //tail beyond r
+                double x;
+                double y;
+                do{
+                    x = -std::log(open_uniform(gen)) / r;
+                    y = -std::log(open_uniform(gen));
+                }while(y + y < x * x);
+                return from_double<T, fraction>(hz > 0 ? r + x : -r - x);
+            }
+
+            //wedge between the layer's rectangle and the curve
+            double x = static_cast<double>(value) / static_cast<double>(int64_t{1} << width_fraction);
+            if(table.density[iz] + open_uniform(gen) * (table.density[iz - 1] - table.density[iz]) < std::exp(-0.5 * x * x)){
+                return to_fixed<T, fraction>(value);
+            }
+        }
+    }
+
+private:
+    template<typename G>
+    static double open_uniform(G& gen){
+        return (static_cast<double>(gen() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+    template<typename T, size_t fraction>
+    static fixed<T, fraction> to_fixed(int64_t q59){
+        return fp_from_bits<T, fraction>(saturate<T>(rounding_shift_right(q59, width_fraction - fraction)));
+    }
+
+    template<typename T, size_t fraction>
+    static fixed<T, fraction> from_double(double x){
+        double scaled = std::round(std::ldexp(x, static_cast<int>(fraction)));
+        return fp_from_bits<T, fraction>(saturate<T>(static_cast<int64_t>(scaled)));
+    }
+};
+
+template<typename T, size_t fraction, typename G>
+inline fixed<T, fraction> normal(G& gen){
+    return normal_ziggurat::sample<T, fraction>(gen);
+}
+
+
+/*
+    bulk fills from counter based streams. element i only depends on seed and first_index + i, so the
+    result is the same for every thread count and a large fill can be split into independently generated pieces.
+    there is no dependency between elements, so the philox rounds of neighbouring elements can be vectorized.
+*/
+template<typename T, size_t fraction>
+inline void fill_uniform01(std::span<fixed<T, fraction>> out, uint64_t seed, uint64_t first_index = 0, size_t threads = 1){
+    parallel_rows(out.size(), threads, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            philox_stream stream(seed, first_index + i);
+            out[i] = uniform01<T, fraction>(stream);
+        }
+    });
+}
+
+template<typename T, size_t fraction>
+inline void fill_uniform(std::span<fixed<T, fraction>> out, fixed<T, fraction> lo, fixed<T, fraction> hi,
+                         uint64_t seed, uint64_t first_index = 0, size_t threads = 1){
+    parallel_rows(out.size(), threads, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            philox_stream stream(seed, first_index + i);
+            out[i] = uniform(stream, lo, hi);
+        }
+    });
+}
+
+template<typename T, size_t fraction>
+inline void fill_normal(std::span<fixed<T, fraction>> out, uint64_t seed, uint64_t first_index = 0, size_t threads = 1){
+    parallel_rows(out.size(), threads, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            philox_stream stream(seed, first_index + i);
+            out[i] = normal<T, fraction>(stream);
+        }
+    });
+}
+
+}//namespace fixed_point
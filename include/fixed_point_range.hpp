@@ -0,0 +1,223 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <limits>
+
+namespace fixed_point{
+
+template<int64_t lo, int64_t hi>
+struct smallest_int{
+    static_assert(lo <= hi, "empty interval");
+    using type = std::conditional_t<lo >= 0,
+        std::conditional_t<hi <= std::numeric_limits<uint8_t>::max(), uint8_t,
+        std::conditional_t<hi <= std::numeric_limits<uint16_t>::max(), uint16_t,
+        std::conditional_t<hi <= std::numeric_limits<uint32_t>::max(), uint32_t, uint64_t>>>,
+        std::conditional_t<lo >= std::numeric_limits<int8_t>::min() and hi <= std::numeric_limits<int8_t>::max(), int8_t,
+        std::conditional_t<lo >= std::numeric_limits<int16_t>::min() and hi <= std::numeric_limits<int16_t>::max(), int16_t,
+        std::conditional_t<lo >= std::numeric_limits<int32_t>::min() and hi <= std::numeric_limits<int32_t>::max(), int32_t, int64_t>>>>;
+};
+
+template<int64_t lo, int64_t hi>
+using smallest_int_t = typename smallest_int<lo, hi>::type;
+
+//interval arithmetic on the bounds happens at compile time, any overflow of int64_t is a compile error
+consteval int64_t checked_add(int64_t a, int64_t b){
+    if(b > 0 and a > std::numeric_limits<int64_t>::max() - b) throw "interval bound overflows int64_t";
+    if(b < 0 and a < std::numeric_limits<int64_t>::min() - b) throw "interval bound overflows int64_t";
+    return a + b;
+}
+
+consteval int64_t checked_neg(int64_t a){
+    if(a == std::numeric_limits<int64_t>::min()) throw "interval bound overflows int64_t";
+    return -a;
+}
+
+consteval int64_t checked_mul(int64_t a, int64_t b){
+    if(a == 0 or b == 0) return 0;
+    int64_t result = static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b));
+    if(result / b != a or (a == -1 and b == std::numeric_limits<int64_t>::min())
+                       or (b == -1 and a == std::numeric_limits<int64_t>::min())){
+        throw "interval bound overflows int64_t";
+    }
+    return result;
+}
+
+consteval int64_t checked_shl(int64_t a, size_t shift){
+    return checked_mul(a, int64_t{1} << shift);
+}
+
+/*
+    fixed point value whose bit representation v is statically known to lie in [lo, hi].
+    every operation widens the interval at compile time and stores its result in the
+    narrowest integer type that can hold it, so no operation can overflow and nothing needs saturating.
+    bounds are given in units of the bit representation, i.e. the value range is [lo * 2^-fraction, hi * 2^-fraction]
+*/
+template<int64_t lo, int64_t hi, size_t fraction>
+struct ranged_fixed{
+    using int_type = smallest_int_t<lo, hi>;
+    static_assert(fraction < 63, "fraction must leave room for the integer part in int64_t bounds");
+
+    int_type v;
+
+    constexpr ranged_fixed() = default;
+
+    //widening from a narrower interval with the same fraction is always safe
+    template<int64_t other_lo, int64_t other_hi>
+    requires(lo <= other_lo and other_hi <= hi)
+    constexpr ranged_fixed(ranged_fixed<other_lo, other_hi, fraction> other){
+        v = static_cast<int_type>(other.v);
+    }
+
+    template<typename T>
+    explicit constexpr ranged_fixed(fixed<T, fraction> f){
+        assert(static_cast<int64_t>(f.v) >= lo and static_cast<int64_t>(f.v) <= hi);
+        v = static_cast<int_type>(f.v);
+    }
+
+    //conversion back to plain fixed, asserts at runtime only if the interval does not fit the target
+    template<typename S, size_t new_frac_bits>
+    explicit constexpr operator fixed<S, new_frac_bits>() const{
+        int64_t bits = v;
+        if constexpr(new_frac_bits >= fraction){
+            bits = bits * (int64_t{1} << (new_frac_bits - fraction));
+        }
+        else{
+            bits = bits >> (fraction - new_frac_bits);
+        }
+        if constexpr(!fits_in<S, new_frac_bits>()){
+            assert(bits >= static_cast<int64_t>(std::numeric_limits<S>::min()));
+            assert(bits <= static_cast<int64_t>(std::numeric_limits<S>::max()));
+        }
+        return fp_from_bits<S, new_frac_bits>(static_cast<S>(bits));
+    }
+
+    template<typename S, size_t new_frac_bits>
+    constexpr static bool fits_in(){
+        int64_t new_lo = lo;
+        int64_t new_hi = hi;
+        if constexpr(new_frac_bits >= fraction){
+            constexpr size_t shift = new_frac_bits - fraction;
+            if(shift >= 63) return lo == 0 and hi == 0;
+            int64_t limit = std::numeric_limits<int64_t>::max() >> shift;
+            if(hi > limit or lo < -limit) return false;
+            new_lo = lo * (int64_t{1} << shift);
+            new_hi = hi * (int64_t{1} << shift);
+        }
+        else{
+            new_lo = lo >> (fraction - new_frac_bits);
+            new_hi = hi >> (fraction - new_frac_bits);
+        }
+        if constexpr(std::is_signed_v<S>){
+            return new_lo >= static_cast<int64_t>(std::numeric_limits<S>::min())
+               and new_hi <= static_cast<int64_t>(std::numeric_limits<S>::max());
+        }
+        else{
+            return new_lo >= 0 and static_cast<uint64_t>(new_hi) <= std::numeric_limits<S>::max();
+        }
+    }
+
+    constexpr static size_t frac_bits(){
+        return fraction;
+    }
+
+    constexpr static int64_t min_as_bits(){
+        return lo;
+    }
+
+    constexpr static int64_t max_as_bits(){
+        return hi;
+    }
+
+    constexpr int64_t to_int() const{
+        return static_cast<int64_t>(v) >> fraction;
+    }
+};
+
+template<typename T>
+struct is_ranged_fixed : std::false_type{};
+
+template<int64_t lo, int64_t hi, size_t fraction>
+struct is_ranged_fixed<ranged_fixed<lo, hi, fraction>> : std::true_type{};
+
+//interval given in whole numbers instead of bits, e.g. ranged_fixed_whole<-4, 4, 16> holds [-4.0, 4.0]
+template<int64_t lo, int64_t hi, size_t fraction>
+using ranged_fixed_whole = ranged_fixed<checked_shl(lo, fraction), checked_shl(hi, fraction), fraction>;
+
+template<int64_t lo, int64_t hi, size_t fraction>
+constexpr inline ranged_fixed<lo, hi, fraction> ranged_from_bits(int64_t i){
+    assert(i >= lo and i <= hi);
+    ranged_fixed<lo, hi, fraction> result;
+    result.v = static_cast<typename ranged_fixed<lo, hi, fraction>::int_type>(i);
+    return result;
+}
+
+//compile time constant with a single point interval, e.g. ranged_constant<fixed<int32_t, 16>(1.5_fixp_t)>()
+template<auto value>
+constexpr inline auto ranged_constant(){
+    using fp_t = decltype(value);
+    return ranged_from_bits<value.v, value.v, fp_t::frac_bits()>(value.v);
+}
+
+//brings a value to a larger number of fractional bits, exact
+template<size_t new_fraction, int64_t lo, int64_t hi, size_t fraction>
+constexpr inline auto align_to(ranged_fixed<lo, hi, fraction> a){
+    static_assert(new_fraction >= fraction, "use truncate_to to drop fractional bits");
+    constexpr size_t shift = new_fraction - fraction;
+    constexpr int64_t new_lo = checked_shl(lo, shift);
+    constexpr int64_t new_hi = checked_shl(hi, shift);
+    return ranged_from_bits<new_lo, new_hi, new_fraction>(static_cast<int64_t>(a.v) * (int64_t{1} << shift));
+}
+
+//drops fractional bits by rounding towards negative infinity
+template<size_t new_fraction, int64_t lo, int64_t hi, size_t fraction>
+constexpr inline auto truncate_to(ranged_fixed<lo, hi, fraction> a){
+    static_assert(new_fraction <= fraction, "use align_to to add fractional bits");
+    constexpr size_t shift = fraction - new_fraction;
+    return ranged_from_bits<(lo >> shift), (hi >> shift), new_fraction>(static_cast<int64_t>(a.v) >> shift);
+}
+
+template<int64_t lo_a, int64_t hi_a, size_t frac_a, int64_t lo_b, int64_t hi_b, size_t frac_b>
+constexpr inline auto operator+(ranged_fixed<lo_a, hi_a, frac_a> a, ranged_fixed<lo_b, hi_b, frac_b> b){
+    constexpr size_t frac = std::max(frac_a, frac_b);
+    auto x = align_to<frac>(a);
+    auto y = align_to<frac>(b);
+    constexpr int64_t lo = checked_add(decltype(x)::min_as_bits(), decltype(y)::min_as_bits());
+    constexpr int64_t hi = checked_add(decltype(x)::max_as_bits(), decltype(y)::max_as_bits());
+    return ranged_from_bits<lo, hi, frac>(static_cast<int64_t>(x.v) + static_cast<int64_t>(y.v));
+}
+
+template<int64_t lo, int64_t hi, size_t fraction>
+constexpr inline auto operator-(ranged_fixed<lo, hi, fraction> a){
+    return ranged_from_bits<checked_neg(hi), checked_neg(lo), fraction>(-static_cast<int64_t>(a.v));
+}
+
+template<int64_t lo_a, int64_t hi_a, size_t frac_a, int64_t lo_b, int64_t hi_b, size_t frac_b>
+constexpr inline auto operator-(ranged_fixed<lo_a, hi_a, frac_a> a, ranged_fixed<lo_b, hi_b, frac_b> b){
+    return a + (-b);
+}
+
+//exact product, the result carries frac_a + frac_b fractional bits
+template<int64_t lo_a, int64_t hi_a, size_t frac_a, int64_t lo_b, int64_t hi_b, size_t frac_b>
+constexpr inline auto operator*(ranged_fixed<lo_a, hi_a, frac_a> a, ranged_fixed<lo_b, hi_b, frac_b> b){
+    constexpr int64_t p0 = checked_mul(lo_a, lo_b);
+    constexpr int64_t p1 = checked_mul(lo_a, hi_b);
+    constexpr int64_t p2 = checked_mul(hi_a, lo_b);
+    constexpr int64_t p3 = checked_mul(hi_a, hi_b);
+    constexpr int64_t lo = std::min({p0, p1, p2, p3});
+    constexpr int64_t hi = std::max({p0, p1, p2, p3});
+    return ranged_from_bits<lo, hi, frac_a + frac_b>(static_cast<int64_t>(a.v) * static_cast<int64_t>(b.v));
+}
+
+template<int64_t lo_a, int64_t hi_a, size_t frac_a, int64_t lo_b, int64_t hi_b, size_t frac_b>
+constexpr inline bool operator==(ranged_fixed<lo_a, hi_a, frac_a> a, ranged_fixed<lo_b, hi_b, frac_b> b){
+    constexpr size_t frac = std::max(frac_a, frac_b);
+    return align_to<frac>(a).v == align_to<frac>(b).v;
+}
+
+template<int64_t lo_a, int64_t hi_a, size_t frac_a, int64_t lo_b, int64_t hi_b, size_t frac_b>
+constexpr inline std::strong_ordering operator<=>(ranged_fixed<lo_a, hi_a, frac_a> a, ranged_fixed<lo_b, hi_b, frac_b> b){
+    constexpr size_t frac = std::max(frac_a, frac_b);
+    return static_cast<int64_t>(align_to<frac>(a).v) <=> static_cast<int64_t>(align_to<frac>(b).v);
+}
+
+}//namespace fixed_point
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_random.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+enum class dither_mode{
+    none,           //round to nearest, the error follows the signal
+    rectangular,    //one uniform value of one target lsb, i.e. stochastic rounding, the mean error is zero
+    triangular      //sum of two uniform values, the error power no longer depends on the signal either
+};
+
+namespace detail{
+
+//c_1 ... c_order with 1 - sum c_k z^-k = (1 - z^-1)^order, the error spectrum is pushed towards high frequencies
+template<size_t order>
+consteval std::array<int64_t, order> noise_shaping_coefficients(){
+    std::array<int64_t, order> result{};
+    int64_t binomial = 1;
+    for(size_t k = 1; k <= order; k++){
+        binomial = binomial * static_cast<int64_t>(order - k + 1) / static_cast<int64_t>(k);
+        result[k - 1] = k % 2 == 1 ? binomial : -binomial;
+    }
+    return result;
+}
+
+}//namespace detail
+
+/*
+    narrows interleaved frames of `channels` source_t samples to target_t with dither and error feedback noise shaping.
+    the quantization error of every sample, dither included, is fed back through the filter above, so the output is
+    x + (1 - z^-1)^order e and the error is moved out of the low frequencies, where a plain conversion leaves it
+    correlated with the signal. order 0 is plain dithered rounding.
+    samples are computed in 64 bit units of the source lsb. the error fed back is the one before saturation,
+    so clipped input does not wind up the filter. the recursion runs along the frames, while the channels of a frame
+    are independent, so the inner loop over the channels vectorizes. the dither of a block of frames is drawn
+    up front from a xoshiro256ss seeded with `seed`, so splitting the input into several process calls
+    does not change the result.
+*/
+template<typename source_t, typename target_t, size_t order = 2>
+class requantizer{
+    using S = typename source_t::int_type;
+    using T = typename target_t::int_type;
+    static_assert(std::is_integral_v<S> and sizeof(S) <= 4 and std::is_integral_v<T> and sizeof(T) <= 4,
+                  "requantizer needs builtin integer types of at most 32 bits");
+    static_assert(target_t::frac_bits() <= source_t::frac_bits(), "the target must have fewer fractional bits, use fixed_cast otherwise");
+    static_assert(order <= 4, "higher orders amplify the total noise too much");
+
+    constexpr static size_t shift = source_t::frac_bits() - target_t::frac_bits();
+    constexpr static std::array<int64_t, order> coefficients = detail::noise_shaping_coefficients<order>();
+
+public:
+    explicit requantizer(size_t channels, dither_mode dither = dither_mode::triangular, uint64_t seed = 0)
+        : channel_count(channels), dither(dither), seed(seed), gen(seed), errors(order * channels, 0){
+        assert(channels > 0);
+    }
+
+    size_t channels() const{
+        return channel_count;
+    }
+
+    //in and out hold whole frames, out[i] is the requantized in[i]
+    void process(std::span<const source_t> in, std::span<target_t> out){
+        assert(in.size() % channel_count == 0 and out.size() >= in.size());
+        constexpr size_t block_frames = 256;
+        const size_t frames = in.size() / channel_count;
+        offsets.resize(block_frames * channel_count);
+        for(size_t start = 0; start < frames; start += block_frames){
+            const size_t count = std::min(block_frames, frames - start);
+            draw_offsets(count * channel_count);
+            for(size_t f = 0; f < count; f++){
+                const size_t base = (start + f) * channel_count;
+                quantize_frame(&in[base], &out[base], &offsets[f * channel_count]);
+            }
+        }
+    }
+
+    //clears the filter state and restarts the dither sequence
+    void reset(){
+        std::fill(errors.begin(), errors.end(), int64_t(0));
+        gen = xoshiro256ss(seed);
+    }
+
+private:
+    /*
+        offset added before the final floor shift, the rounding half plus the dither.
+        the two uniform values of the triangular dither are the top bits of the halves of one draw.
+    */
+    void draw_offsets(size_t n){
+        constexpr int64_t half = shift > 0 ? int64_t{1} << (shift - 1) : 0;
+        if(shift == 0 or dither == dither_mode::none){
+            std::fill_n(offsets.begin(), n, half);
+        }
+        else if(dither == dither_mode::rectangular){
+            for(size_t i = 0; i < n; i++) offsets[i] = static_cast<int64_t>(gen() >> (64 - shift));
+        }
+        else{
+            for(size_t i = 0; i < n; i++){
+                uint64_t bits = gen();
+                int64_t a = static_cast<int64_t>(static_cast<uint32_t>(bits) >> (32 - shift));
+                int64_t b = static_cast<int64_t>((bits >> 32) >> (32 - shift));
+                offsets[i] = half + a - b;
+            }
+        }
+    }
+
+    void quantize_frame(const source_t* in, target_t* out, const int64_t* offset){
+        constexpr int64_t scale = int64_t{1} << shift;
+        const size_t n = channel_count;
+        int64_t* e = errors.data();
+        for(size_t c = 0; c < n; c++){
+            int64_t wanted = static_cast<int64_t>(in[c].v);
+            for(size_t k = 0; k < order; k++) wanted -= coefficients[k] * e[k * n + c];
+            int64_t q = (wanted + offset[c]) >> shift;
+            out[c] = fp_from_bits<T, target_t::frac_bits()>(saturate<T>(q));
+            for(size_t k = order; k-- > 1;) e[k * n + c] = e[(k - 1) * n + c];
+            if constexpr(order > 0) e[c] = q * scale - wanted;
+        }
+    }
+
+    size_t channel_count;
+    dither_mode dither;
+    uint64_t seed;
+    xoshiro256ss gen;
+    std::vector<int64_t> errors;    //errors[k * channels + c] is the error of channel c k + 1 frames ago
+    std::vector<int64_t> offsets;
+};
+
+//requantizes a whole buffer of interleaved frames in one go
+template<typename target_t, size_t order = 2, typename source_t>
+inline void requantize(std::span<const source_t> in, std::span<target_t> out, size_t channels = 1,
+                       dither_mode dither = dither_mode::triangular, uint64_t seed = 0){
+    requantizer<source_t, target_t, order> r(channels, dither, seed);
+    r.process(in, out);
+}
+
+}//namespace fixed_point
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include "fixed_point_parallel.hpp"
+#include <array>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+namespace detail{
+
+//v as an unsigned key in the same order as the values, the sign bit of signed types is flipped
+template<typename T>
+constexpr inline std::make_unsigned_t<T> radix_key(T v){
+    using U = std::make_unsigned_t<T>;
+    constexpr U sign_flip = std::is_signed_v<T> ? U(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+    return static_cast<U>(static_cast<U>(v) ^ sign_flip);
+}
+
+template<typename T>
+constexpr inline size_t radix_digit(T v, size_t shift){
+    return static_cast<size_t>((radix_key(v) >> shift) & 0xff);
+}
+
+}//namespace detail
+
+
+/*
+    stable lsd radix sort on the bytes of v, one counting pass and one scatter pass per byte.
+    passes in which all values share the same byte are skipped.
+    with several threads every thread counts and scatters its own contiguous part of the input, the
+    offsets are assigned digit by digit and thread by thread so the result stays stable.
+    needs a scratch buffer as large as data.
+*/
+template<typename T, size_t fraction>
+inline void radix_sort(std::span<fixed<T, fraction>> data, size_t threads = 1){
+    static_assert(std::is_integral_v<T>, "radix_sort needs a builtin integer type");
+    const size_t n = data.size();
+    if(n < 2) return;
+    threads = std::max<size_t>(1, std::min(threads, n));
+    const size_t chunk = (n + threads - 1) / threads;
+
+    std::vector<fixed<T, fraction>> buffer(n);
+    fixed<T, fraction>* src = data.data();
+    fixed<T, fraction>* dst = buffer.data();
+    std::vector<std::array<size_t, 256>> counts(threads);
+
+    for(size_t shift = 0; shift < sizeof(T) * 8; shift += 8){
+        parallel_rows(threads, threads, [&](size_t first, size_t last){
+            for(size_t t = first; t < last; t++){
+                counts[t].fill(0);
+                for(size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); i++) counts[t][detail::radix_digit(src[i].v, shift)]++;
+            }
+        });
+
+        size_t running = 0;
+        bool trivial = false;
+        for(size_t d = 0; d < 256; d++){
+            size_t total = 0;
+            for(size_t t = 0; t < threads; t++){
+                size_t c = counts[t][d];
+                counts[t][d] = running;
+                running += c;
+                total += c;
+            }
+            trivial |= total == n;
+        }
+        if(trivial) continue;
+
+        parallel_rows(threads, threads, [&](size_t first, size_t last){
+            for(size_t t = first; t < last; t++){
+                auto& offset = counts[t];
+                for(size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); i++) dst[offset[detail::radix_digit(src[i].v, shift)]++] = src[i];
+            }
+        });
+        std::swap(src, dst);
+    }
+    if(src != data.data()) std::copy(src, src + n, data.data());
+}
+
+
+/*
+    index of the first element not less than x in sorted data, like std::lower_bound.
+    the search halves the range without branching on the comparison, which compiles to a conditional
+    move, so it does not suffer from mispredictions on random queries.
+*/
+template<typename T, size_t fraction>
+inline size_t lower_bound(std::span<const fixed<T, fraction>> data, fixed<T, fraction> x){
+    const fixed<T, fraction>* base = data.data();
+    size_t n = data.size();
+    if(n == 0) return 0;
+    while(n > 1){
+        size_t half = n / 2;
+        base = base[half - 1].v < x.v ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - data.data()) + (base->v < x.v);
+}
+
+//index of the first element greater than x in sorted data, like std::upper_bound
+template<typename T, size_t fraction>
+inline size_t upper_bound(std::span<const fixed<T, fraction>> data, fixed<T, fraction> x){
+    const fixed<T, fraction>* base = data.data();
+    size_t n = data.size();
+    if(n == 0) return 0;
+    while(n > 1){
+        size_t half = n / 2;
+        base = base[half - 1].v <= x.v ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - data.data()) + (base->v <= x.v);
+}
+
+/*
+    lower_bound for many queries. the searches are independent, so running them in lock step lets the
+    loads of different queries overlap instead of waiting for one dependent load after the other.
+*/
+template<typename T, size_t fraction>
+inline void lower_bound(std::span<const fixed<T, fraction>> data, std::span<const fixed<T, fraction>> queries, std::span<size_t> out){
+    assert(out.size() >= queries.size());
+    constexpr size_t lanes = 8;
+    size_t q = 0;
+    for(; q + lanes <= queries.size() and not data.empty(); q += lanes){
+        std::array<const fixed<T, fraction>*, lanes> base;
+        base.fill(data.data());
+        size_t n = data.size();
+        while(n > 1){
+            size_t half = n / 2;
+            for(size_t l = 0; l < lanes; l++) base[l] = base[l][half - 1].v < queries[q + l].v ? base[l] + half : base[l];
+            n -= half;
+        }
+        for(size_t l = 0; l < lanes; l++) out[q + l] = static_cast<size_t>(base[l] - data.data()) + (base[l]->v < queries[q + l].v);
+    }
+    for(; q < queries.size(); q++) out[q] = lower_bound(data, queries[q]);
+}
+
+
+/*
+    k-th smallest value (0 based) by msd radix selection: the top byte of every candidate is counted,
+    only the candidates in the bucket holding rank k are kept, and the next byte decides among them.
+    reads data once and then works on ever fewer candidates, data itself is not modified.
+*/
+template<typename T, size_t fraction>
+inline fixed<T, fraction> select_nth(std::span<const fixed<T, fraction>> data, size_t k){
+    static_assert(std::is_integral_v<T>, "select_nth needs a builtin integer type");
+    assert(k < data.size());
+    using U = std::make_unsigned_t<T>;
+    std::vector<T> candidates;
+    U prefix = 0;
+    U prefix_mask = 0;
+
+    for(size_t shift = sizeof(T) * 8; shift > 0;){
+        shift -= 8;
+        std::array<size_t, 256> counts{};
+        if(prefix_mask == 0){
+            for(const auto& x : data) counts[detail::radix_digit(x.v, shift)]++;
+        }
+        else{
+            for(T v : candidates) counts[detail::radix_digit(v, shift)]++;
+        }
+
+        size_t digit = 0;
+        while(k >= counts[digit]){
+            k -= counts[digit];
+            digit++;
+        }
+        prefix |= static_cast<U>(static_cast<U>(digit) << shift);
+        prefix_mask |= static_cast<U>(U(0xff) << shift);
+
+        //keep only the values which agree with the prefix so far
+        if(shift == 0) break;
+        if(candidates.empty()){
+            candidates.reserve(counts[digit]);
+            for(const auto& x : data){
+                if((detail::radix_key(x.v) & prefix_mask) == prefix) candidates.push_back(x.v);
+            }
+        }
+        else{
+            size_t kept = 0;
+            for(T v : candidates){
+                if((detail::radix_key(v) & prefix_mask) == prefix) candidates[kept++] = v;
+            }
+            candidates.resize(kept);
+        }
+    }
+    return fp_from_bits<T, fraction>(static_cast<T>(detail::radix_key(static_cast<T>(prefix))));
+}
+
+//rearranges data like std::nth_element: data[k] is the k-th smallest, nothing before it is larger and nothing after it smaller
+template<typename T, size_t fraction>
+inline void nth_element(std::span<fixed<T, fraction>> data, size_t k){
+    auto pivot = select_nth(std::span<const fixed<T, fraction>>(data), k);
+    auto less_end = std::partition(data.begin(), data.end(), [pivot](auto x){ return x.v < pivot.v; });
+    std::partition(less_end, data.end(), [pivot](auto x){ return x.v == pivot.v; });
+}
+
+//lower median, the element at rank (n - 1) / 2
+template<typename T, size_t fraction>
+inline fixed<T, fraction> median(std::span<const fixed<T, fraction>> data){
+    return select_nth(data, (data.size() - 1) / 2);
+}
+
+//nearest rank percentile for q in [0, 1]: the smallest value with at least q * n values at or below it
+template<typename T, size_t fraction>
+inline fixed<T, fraction> percentile(std::span<const fixed<T, fraction>> data, double q){
+    assert(not data.empty() and q >= 0.0 and q <= 1.0);
+    double rank = std::ceil(q * static_cast<double>(data.size()));
+    size_t k = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+    return select_nth(data, std::min(k, data.size() - 1));
+}
+
+}//namespace fixed_point
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "fixed_point_math.hpp"
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace fixed_point{
+
+namespace detail{
+
+//a / b rounded to nearest with ties away from zero, for b > 0
+template<typename W>
+constexpr inline W rounded_divide(W a, W b){
+    W half = b >> 1;
+    return a < W(0) ? -((-a + half) / b) : (a + half) / b;
+}
+
+}//namespace detail
+
+
+/*
+    single pass count, min, max, mean and variance of a stream of fixed values.
+    instead of updating a running mean with a division per sample, like welford's method does for floats,
+    the state is the exact sum and sum of squares of v in wide integers. they never round or overflow,
+    so mean and variance are computed with a single rounding when they are asked for, and two states
+    of different threads merge exactly by adding them up.
+*/
+template<typename T, size_t fraction>
+class running_stats{
+    static_assert(std::is_integral_v<T>, "running_stats needs a builtin integer type");
+
+public:
+    using value_type = fixed<T, fraction>;
+    using sum_type = wide_int<128>;
+    using square_sum_type = wide_int<sizeof(T) <= 4 ? 128 : 256>;
+
+    void add(value_type x){
+        sum += sum_type(x.v);
+        square_sum += square_sum_type(static_cast<product_t<T>>(x.v) * static_cast<product_t<T>>(x.v));
+        lowest = std::min(lowest, x.v);
+        highest = std::max(highest, x.v);
+        n++;
+    }
+
+    //sums blocks of values in narrow accumulators first, the wide state is only touched once per block
+    void add(std::span<const value_type> values){
+        using local_sum_t = accumulator_t<T>;
+        using local_square_t = accumulator_t<product_t<T>>;
+        constexpr size_t block = 4096;
+        for(size_t start = 0; start < values.size(); start += block){
+            size_t end = std::min(values.size(), start + block);
+            local_sum_t local_sum = 0;
+            local_square_t local_square = 0;
+            T local_lowest = lowest;
+            T local_highest = highest;
+            for(size_t i = start; i < end; i++){
+                T v = values[i].v;
+                local_sum += local_sum_t(v);
+                local_square += local_square_t(static_cast<product_t<T>>(v) * static_cast<product_t<T>>(v));
+                local_lowest = std::min(local_lowest, v);
+                local_highest = std::max(local_highest, v);
+            }
+            sum += sum_type(local_sum);
+            square_sum += square_sum_type(local_square);
+            lowest = local_lowest;
+            highest = local_highest;
+            n += end - start;
+        }
+    }
+
+    //combines the statistics of another part of the stream into this one
+    void merge(const running_stats& other){
+        sum += other.sum;
+        square_sum += other.square_sum;
+        lowest = std::min(lowest, other.lowest);
+        highest = std::max(highest, other.highest);
+        n += other.n;
+    }
+
+    void reset(){
+        *this = running_stats{};
+    }
+
+    uint64_t count() const{
+        return n;
+    }
+
+    value_type min() const{
+        assert(n > 0);
+        return fp_from_bits<T, fraction>(lowest);
+    }
+
+    value_type max() const{
+        assert(n > 0);
+        return fp_from_bits<T, fraction>(highest);
+    }
+
+    //exact sum of all values in units of the last fractional bit
+    sum_type raw_sum() const{
+        return sum;
+    }
+
+    value_type mean() const{
+        assert(n > 0);
+        return fp_from_bits<T, fraction>(saturate<T>(detail::rounded_divide(sum, sum_type(n))));
+    }
+
+    //population variance, the mean squared deviation from the mean, saturated if it does not fit
+    value_type variance() const{
+        assert(n > 0);
+        return fp_from_bits<T, fraction>(saturate<T>(scaled_variance(wide_type(n) * wide_type(n))));
+    }
+
+    //unbiased sample variance, dividing by n - 1
+    value_type sample_variance() const{
+        assert(n > 1);
+        return fp_from_bits<T, fraction>(saturate<T>(scaled_variance(wide_type(n) * wide_type(n - 1))));
+    }
+
+    //population standard deviation, the square root of n * sum of squares - sum^2 divided by n
+    value_type stddev() const{
+        assert(n > 0);
+        wide_type root(rounded_integer_sqrt(wide_uint<256>(deviation_sum())));
+        return fp_from_bits<T, fraction>(saturate<T>(detail::rounded_divide(root, wide_type(n))));
+    }
+
+private:
+    //n * sum of squares needs 64 bits more than the sum of squares
+    using wide_type = wide_int<256>;
+
+    //n^2 times the population variance in units of v^2, never negative
+    wide_type deviation_sum() const{
+        wide_type s(sum);
+        return wide_type(n) * wide_type(square_sum) - s * s;
+    }
+
+    //variance in units of the last fractional bit for the given divisor of deviation_sum
+    wide_type scaled_variance(wide_type divisor) const{
+        return detail::rounded_divide(deviation_sum(), divisor << fraction);
+    }
+
+    sum_type sum = 0;
+    square_sum_type square_sum = 0;
+    T lowest = std::numeric_limits<T>::max();
+    T highest = std::numeric_limits<T>::min();
+    uint64_t n = 0;
+};
+
+
+/*
+    exponentially weighted moving average with alpha = 2^-shift, which needs no multiply at all.
+    the state keeps shift extra fractional bits, so small steps towards a new value are not lost to rounding
+    and a constant input is reached exactly. the first sample initializes the average.
+*/
+template<typename T, size_t fraction, size_t shift>
+class ewma_shift{
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "ewma_shift needs a builtin integer type of at most 32 bits");
+    static_assert(shift >= 1 and shift <= 30, "shift between 1 and 30");
+
+public:
+    using value_type = fixed<T, fraction>;
+
+    void add(value_type x){
+        if(not primed){
+            state = static_cast<int64_t>(x.v) << shift;
+            primed = true;
+            return;
+        }
+        state += static_cast<int64_t>(x.v) - rounding_shift_right(state, shift);
+    }
+
+    void add(std::span<const value_type> values){
+        for(const auto& x : values) add(x);
+    }
+
+    value_type value() const{
+        return fp_from_bits<T, fraction>(static_cast<T>(rounding_shift_right(state, shift)));
+    }
+
+    void reset(){
+        state = 0;
+        primed = false;
+    }
+
+private:
+    int64_t state = 0;
+    bool primed = false;
+};
+
+
+/*
+    exponentially weighted moving average with any alpha in (0, 1], given in Q30.
+    the state keeps 16 extra fractional bits, the update is a single multiply and rounding shift.
+    the first sample initializes the average.
+*/
+template<typename T, size_t fraction>
+class ewma{
+    static_assert(std::is_integral_v<T> and sizeof(T) <= 4, "ewma needs a builtin integer type of at most 32 bits");
+
+public:
+    using value_type = fixed<T, fraction>;
+    using alpha_type = fixed<int32_t, 30>;
+
+    //alpha = 2 / (n + 1), which gives the same center of mass as a simple moving average over n samples
+    constexpr static alpha_type alpha_for_window(uint64_t n){
+        assert(n > 0);
+        return fp_from_bits<int32_t, 30>(static_cast<int32_t>(((uint64_t{2} << 30) + (n + 1) / 2) / (n + 1)));
+    }
+
+    constexpr explicit ewma(alpha_type alpha) : alpha(alpha){
+        assert(alpha.v > 0 and alpha.v <= (int32_t{1} << 30));
+    }
+
+    void add(value_type x){
+        int64_t target = static_cast<int64_t>(x.v) << guard_bits;
+        if(not primed){
+            state = target;
+            primed = true;
+            return;
+        }
+        state += static_cast<int64_t>(rounding_shift_right(wide_product(int64_t{alpha.v}, target - state), 30));
+    }
+
+    void add(std::span<const value_type> values){
+        for(const auto& x : values) add(x);
+    }
+
+    value_type value() const{
+        return fp_from_bits<T, fraction>(static_cast<T>(rounding_shift_right(state, guard_bits)));
+    }
+
+    void reset(){
+        state = 0;
+        primed = false;
+    }
+
+private:
+    constexpr static size_t guard_bits = 16;
+
+    alpha_type alpha;
+    int64_t state = 0;
+    bool primed = false;
+};
+
+
+namespace detail{
+
+/*
+    ring buffer of (index, value) pairs whose values are monotonic from front to back, the front is the extreme
+    of the window. a new value removes all values from the back it dominates, so every value is pushed and popped
+    at most once and an update costs amortized constant time.
+*/
+template<typename T, bool keep_max>
+class monotonic_queue{
+public:
+    explicit monotonic_queue(size_t window) : entries(window){
+    }
+
+    void push(uint64_t index, T v){
+        const size_t window = entries.size();
+        while(count > 0 and entries[head].index + window <= index){
+            head = head + 1 == window ? 0 : head + 1;
+            count--;
+        }
+        while(count > 0 and dominated(entries[back()].v, v)) count--;
+        size_t slot = head + count >= window ? head + count - window : head + count;
+        entries[slot] = {index, v};
+        count++;
+    }
+
+    T front() const{
+        assert(count > 0);
+        return entries[head].v;
+    }
+
+    void clear(){
+        head = 0;
+        count = 0;
+    }
+
+private:
+    struct entry{
+        uint64_t index;
+        T v;
+    };
+
+    static bool dominated(T old_value, T new_value){
+        return keep_max ? old_value <= new_value : old_value >= new_value;
+    }
+
+    size_t back() const{
+        size_t last = head + count - 1;
+        return last >= entries.size() ? last - entries.size() : last;
+    }
+
+    std::vector<entry> entries;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+}//namespace detail
+
+//minimum and maximum of the last `window` samples in amortized constant time per sample
+template<typename T, size_t fraction>
+class windowed_minmax{
+public:
+    using value_type = fixed<T, fraction>;
+
+    explicit windowed_minmax(size_t window) : window_size(window), lowest(window), highest(window){
+        assert(window > 0);
+    }
+
+    void add(value_type x){
+        lowest.push(n, x.v);
+        highest.push(n, x.v);
+        n++;
+    }
+
+    void add(std::span<const value_type> values){
+        for(const auto& x : values) add(x);
+    }
+
+    value_type min() const{
+        return fp_from_bits<T, fraction>(lowest.front());
+    }
+
+    value_type max() const{
+        return fp_from_bits<T, fraction>(highest.front());
+    }
+
+    size_t window() const{
+        return window_size;
+    }
+
+    //number of samples currently in the window
+    size_t size() const{
+        return static_cast<size_t>(std::min<uint64_t>(n, window_size));
+    }
+
+    void reset(){
+        lowest.clear();
+        highest.clear();
+        n = 0;
+    }
+
+private:
+    size_t window_size;
+    detail::monotonic_queue<T, false> lowest;
+    detail::monotonic_queue<T, true> highest;
+    uint64_t n = 0;
+};
+
+}//namespace fixed_point
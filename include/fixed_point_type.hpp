@@ -7,6 +7,7 @@
 #include <cassert>
 #include <algorithm>
 #include <compare>
+#include <limits>
 
 namespace fixed_point{
 
@@ -81,7 +82,7 @@ constexpr inline fixed_construction_helper<S> operator+(fixed_construction_helpe
 template<typename T, size_t fraction>
 struct fixed{
     using int_type = T;
-    static_assert(std::is_integral_v<int_type>, "int_type must be an integer type");
+    static_assert(std::numeric_limits<int_type>::is_integer, "int_type must be an integer type");
     static_assert(fraction <= sizeof(int_type) * 8, "can not have more fractional bits than there are bits in the int");
     
     int_type v;
@@ -99,18 +100,32 @@ struct fixed{
         v = i << frac_bits();
     }
     
+    //builtin integers only convert to a class type int_type like wide_int with one user defined conversion, so take them directly
+    template<typename I> requires (std::is_integral_v<I> and not std::is_integral_v<int_type>)
+    constexpr fixed(I i) : fixed(int_type(i)){
+    }
+    
     template<size_t S>
     constexpr fixed(fixed_construction_helper<S> helper){
-    
-        int64_t result = (helper.whole << fraction) | (helper.frac >> (64 - fraction));
-        if((helper.frac >> (64-fraction-1)) & 1) result++;
+        //the literal holds 64 fractional bits, types wider than 64 bits assemble it in int_type itself
+        using wide_t = std::conditional_t<(sizeof(int_type) > 8), int_type, int64_t>;
+        wide_t result = static_cast<wide_t>(helper.whole) << fraction;
+        if constexpr(fraction > 64){
+            result |= static_cast<wide_t>(helper.frac) << (fraction - 64);
+        }
+        else if constexpr(fraction > 0){
+            result |= static_cast<wide_t>(helper.frac >> (64 - fraction));
+        }
+        if constexpr(fraction < 64){
+            if((helper.frac >> (64 - fraction - 1)) & 1) result++;
+        }
 
         if(helper.negative) result = -result;
-        v = result;
+        v = static_cast<int_type>(result);
     }
     
     constexpr fixed& operator=(int i){
-        v = i << frac_bits();
+        v = int_type(i) << frac_bits();
         return *this;
     }
     
@@ -151,19 +166,19 @@ struct fixed{
     }
     
     constexpr static int_type frac_mask(){
-        return (1 << frac_bits())-1;
+        return (int_type(1) << frac_bits())-1;
     }
     
     constexpr static bool is_signed(){
-        return std::is_signed_v<int_type>;
+        return std::numeric_limits<int_type>::is_signed;
     }
     
     constexpr static int_type supremum_as_int(){ //returns the maximum representable value + 1
-        return 1 << whole_bits();
+        return int_type(1) << whole_bits();
     }
     
     constexpr static int_type max_as_int(){
-        return (1 << whole_bits()) - 1;
+        return (int_type(1) << whole_bits()) - 1;
     }
     
     constexpr static int_type minimum_as_int(){
@@ -188,8 +203,18 @@ struct fixed{
     }
     
     
-    constexpr std::array<char, 12> to_string() const{
-        std::array<char, 12> digits = {0};
+    //sign, every decimal digit the int can hold, the dot and the terminating zero
+    constexpr static size_t string_size(){
+        if constexpr(sizeof(int_type) <= 4){
+            return 12;
+        }
+        else{
+            return static_cast<size_t>(std::numeric_limits<int_type>::digits10) + 5;
+        }
+    }
+    
+    constexpr std::array<char, string_size()> to_string() const{
+        std::array<char, string_size()> digits = {0};
         size_t idx = 0;
         size_t start = 0;
         
@@ -209,7 +234,7 @@ struct fixed{
         }
         else{
             while(whole){
-                digits[idx++] = (whole % 10) + '0';
+                digits[idx++] = static_cast<char>(whole % 10 + '0');
                 whole /= 10;
             }
         }
@@ -219,7 +244,7 @@ struct fixed{
         
         for(; idx < digits.size()-1; idx++){
             frac *= 10;
-            digits[idx] = (frac >> frac_bits()) + '0'; 
+            digits[idx] = static_cast<char>((frac >> frac_bits()) + '0');
             frac = frac & frac_mask();
         }
         return digits;
@@ -0,0 +1,585 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace fixed_point{
+
+namespace detail{
+
+//a + b + carry, written so that compilers turn a chain of these into add with carry instructions
+constexpr inline uint64_t add_with_carry(uint64_t a, uint64_t b, bool& carry){
+    uint64_t sum = a + b;
+    bool overflow = sum < a;
+    uint64_t result = sum + carry;
+    carry = overflow or result < sum;
+    return result;
+}
+
+//a - b - borrow, the same for subtract with borrow
+constexpr inline uint64_t sub_with_borrow(uint64_t a, uint64_t b, bool& borrow){
+    uint64_t difference = a - b;
+    bool underflow = a < b;
+    uint64_t result = difference - borrow;
+    borrow = underflow or difference < static_cast<uint64_t>(borrow);
+    return result;
+}
+
+//full 128 bit product of two limbs, returns the low half
+constexpr inline uint64_t multiply_limbs(uint64_t a, uint64_t b, uint64_t& high){
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128;
+    uint128 product = static_cast<uint128>(a) * b;
+    high = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#else
+    uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+    uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t middle = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+    high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+    return (middle << 32) | (p00 & 0xffffffff);
+#endif
+}
+
+//dst[0, size) += src[0, src_size), returns the carry out of dst
+constexpr inline bool add_limbs(uint64_t* dst, size_t size, const uint64_t* src, size_t src_size){
+    bool carry = false;
+    for(size_t i = 0; i < size; i++) dst[i] = add_with_carry(dst[i], i < src_size ? src[i] : 0, carry);
+    return carry;
+}
+
+//dst[0, size) -= src[0, src_size), returns the borrow out of dst
+constexpr inline bool sub_limbs(uint64_t* dst, size_t size, const uint64_t* src, size_t src_size){
+    bool borrow = false;
+    for(size_t i = 0; i < size; i++) dst[i] = sub_with_borrow(dst[i], i < src_size ? src[i] : 0, borrow);
+    return borrow;
+}
+
+template<size_t n, size_t m>
+constexpr std::array<uint64_t, n + m> schoolbook_multiply(const std::array<uint64_t, n>& a, const std::array<uint64_t, m>& b){
+    std::array<uint64_t, n + m> result{};
+    for(size_t i = 0; i < n; i++){
+        uint64_t carry = 0;
+        for(size_t j = 0; j < m; j++){
+            //a[i] * b[j] + result[i + j] + carry < 2^128, so the high half can not overflow
+            uint64_t high;
+            uint64_t low = multiply_limbs(a[i], b[j], high);
+            bool c = false;
+            low = add_with_carry(low, carry, c);
+            high += c;
+            c = false;
+            result[i + j] = add_with_carry(result[i + j], low, c);
+            carry = high + c;
+        }
+        result[i + m] = carry;
+    }
+    return result;
+}
+
+//only the low n limbs of the product, which is all a truncating multiply needs
+template<size_t n>
+constexpr std::array<uint64_t, n> truncated_multiply(const std::array<uint64_t, n>& a, const std::array<uint64_t, n>& b){
+    std::array<uint64_t, n> result{};
+    for(size_t i = 0; i < n; i++){
+        uint64_t carry = 0;
+        for(size_t j = 0; i + j < n; j++){
+            uint64_t high;
+            uint64_t low = multiply_limbs(a[i], b[j], high);
+            bool c = false;
+            low = add_with_carry(low, carry, c);
+            high += c;
+            c = false;
+            result[i + j] = add_with_carry(result[i + j], low, c);
+            carry = high + c;
+        }
+    }
+    return result;
+}
+
+//below this many limbs schoolbook multiplication is faster than karatsuba
+constexpr inline size_t karatsuba_threshold = 8;
+
+/*
+    full product of two n limb numbers. above the threshold one level of karatsuba splits each factor into
+    halves a = a1 B + a0 and computes a1 b1, a0 b0 and (a0 + a1)(b0 + b1) instead of four half products.
+*/
+template<size_t n>
+constexpr std::array<uint64_t, 2 * n> multiply_full(const std::array<uint64_t, n>& a, const std::array<uint64_t, n>& b){
+    if constexpr(n < karatsuba_threshold or n % 2 != 0){
+        return schoolbook_multiply(a, b);
+    }
+    else{
+        constexpr size_t h = n / 2;
+        std::array<uint64_t, h> a0{}, a1{}, b0{}, b1{};
+        for(size_t i = 0; i < h; i++){
+            a0[i] = a[i];
+            a1[i] = a[i + h];
+            b0[i] = b[i];
+            b1[i] = b[i + h];
+        }
+        auto z0 = multiply_full<h>(a0, b0);
+        auto z2 = multiply_full<h>(a1, b1);
+
+        //the sums of the halves have one extra bit each, ca and cb
+        auto sa = a0;
+        auto sb = b0;
+        bool ca = add_limbs(sa.data(), h, a1.data(), h);
+        bool cb = add_limbs(sb.data(), h, b1.data(), h);
+        auto p = multiply_full<h>(sa, sb);
+        std::array<uint64_t, n + 1> z1{};
+        for(size_t i = 0; i < n; i++) z1[i] = p[i];
+        //(sa + ca B)(sb + cb B) = sa sb + B (ca sb + cb sa) + ca cb B^2
+        if(ca) add_limbs(z1.data() + h, h + 1, sb.data(), h);
+        if(cb) add_limbs(z1.data() + h, h + 1, sa.data(), h);
+        if(ca and cb) z1[n]++;
+        sub_limbs(z1.data(), n + 1, z0.data(), n);
+        sub_limbs(z1.data(), n + 1, z2.data(), n);
+
+        std::array<uint64_t, 2 * n> result{};
+        for(size_t i = 0; i < n; i++){
+            result[i] = z0[i];
+            result[i + n] = z2[i];
+        }
+        add_limbs(result.data() + h, 2 * n - h, z1.data(), n + 1);
+        return result;
+    }
+}
+
+/*
+    unsigned division, knuth's algorithm d on 32 bit digits so every trial quotient
+    is a single 64 by 32 bit division. divisors of one digit take a short division.
+*/
+template<size_t n>
+constexpr void divide_limbs(const std::array<uint64_t, n>& a, const std::array<uint64_t, n>& b,
+                            std::array<uint64_t, n>& quotient, std::array<uint64_t, n>& remainder){
+    constexpr size_t digits = 2 * n;
+    std::array<uint32_t, digits> u{}, v{}, q{}, r{};
+    for(size_t i = 0; i < n; i++){
+        u[2 * i] = static_cast<uint32_t>(a[i]);
+        u[2 * i + 1] = static_cast<uint32_t>(a[i] >> 32);
+        v[2 * i] = static_cast<uint32_t>(b[i]);
+        v[2 * i + 1] = static_cast<uint32_t>(b[i] >> 32);
+    }
+    size_t m = digits;
+    while(m > 0 and u[m - 1] == 0) m--;
+    size_t dn = digits;
+    while(dn > 0 and v[dn - 1] == 0) dn--;
+    assert(dn > 0 and "division by zero");
+
+    if(m < dn){
+        quotient = {};
+        remainder = a;
+        return;
+    }
+
+    if(dn == 1){
+        uint64_t k = 0;
+        for(size_t j = m; j-- > 0;){
+            uint64_t t = (k << 32) | u[j];
+            q[j] = static_cast<uint32_t>(t / v[0]);
+            k = t - static_cast<uint64_t>(q[j]) * v[0];
+        }
+        r[0] = static_cast<uint32_t>(k);
+    }
+    else{
+        //normalize so the top digit of the divisor has its high bit set, which bounds the trial quotient error by 2
+        int s = std::countl_zero(v[dn - 1]);
+        std::array<uint32_t, digits> vn{};
+        std::array<uint32_t, digits + 1> un{};
+        for(size_t i = dn - 1; i > 0; i--) vn[i] = (v[i] << s) | (s ? v[i - 1] >> (32 - s) : 0);
+        vn[0] = v[0] << s;
+        un[m] = s ? u[m - 1] >> (32 - s) : 0;
+        for(size_t i = m - 1; i > 0; i--) un[i] = (u[i] << s) | (s ? u[i - 1] >> (32 - s) : 0);
+        un[0] = u[0] << s;
+
+        for(size_t j = m - dn + 1; j-- > 0;){
+            uint64_t numerator = (static_cast<uint64_t>(un[j + dn]) << 32) | un[j + dn - 1];
+            uint64_t qhat = numerator / vn[dn - 1];
+            uint64_t rhat = numerator - qhat * vn[dn - 1];
+            while((qhat >> 32) != 0 or qhat * vn[dn - 2] > ((rhat << 32) | un[j + dn - 2])){
+                qhat--;
+                rhat += vn[dn - 1];
+                if((rhat >> 32) != 0) break;
+            }
+
+            //un[j, j + dn] -= qhat * vn
+            int64_t k = 0;
+            int64_t t = 0;
+            for(size_t i = 0; i < dn; i++){
+                uint64_t p = qhat * vn[i];
+                t = static_cast<int64_t>(un[i + j]) - k - static_cast<int64_t>(p & 0xffffffff);
+                un[i + j] = static_cast<uint32_t>(t);
+                k = static_cast<int64_t>(p >> 32) - (t >> 32);
+            }
+            t = static_cast<int64_t>(un[j + dn]) - k;
+            un[j + dn] = static_cast<uint32_t>(t);
+
+            q[j] = static_cast<uint32_t>(qhat);
+            //qhat was one too large, add the divisor back
+            if(t < 0){
+                q[j]--;
+                uint64_t carry = 0;
+                for(size_t i = 0; i < dn; i++){
+                    uint64_t sum = static_cast<uint64_t>(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<uint32_t>(sum);
+                    carry = sum >> 32;
+                }
+                un[j + dn] += static_cast<uint32_t>(carry);
+            }
+        }
+        for(size_t i = 0; i < dn; i++) r[i] = (un[i] >> s) | (s ? un[i + 1] << (32 - s) : 0);
+    }
+
+    for(size_t i = 0; i < n; i++){
+        quotient[i] = (static_cast<uint64_t>(q[2 * i + 1]) << 32) | q[2 * i];
+        remainder[i] = (static_cast<uint64_t>(r[2 * i + 1]) << 32) | r[2 * i];
+    }
+}
+
+}//namespace detail
+
+
+/*
+    two's complement integer of `bits` bits made of 64 bit limbs, least significant limb first.
+    behaves like the builtin integers: arithmetic wraps, division truncates towards zero and
+    right shifts of signed values are arithmetic. everything is constexpr, so it can be used as int_type of fixed.
+*/
+template<size_t bits, bool is_signed_int = true>
+struct wide_int{
+    static_assert(bits % 64 == 0 and bits >= 128, "wide_int needs a multiple of 64 bits, at least 128");
+
+    constexpr static size_t limb_count = bits / 64;
+
+    std::array<uint64_t, limb_count> limbs;
+
+    constexpr wide_int() = default;
+
+    template<typename I> requires std::is_integral_v<I>
+    constexpr wide_int(I x) : limbs{}{
+        limbs[0] = static_cast<uint64_t>(x);
+        if constexpr(std::is_signed_v<I>){
+            if(x < 0){
+                for(size_t i = 1; i < limb_count; i++) limbs[i] = ~uint64_t{0};
+            }
+        }
+    }
+
+    //widening keeps the value, narrowing keeps the low bits
+    template<size_t other_bits, bool other_signed>
+    constexpr explicit(other_bits > bits) wide_int(const wide_int<other_bits, other_signed>& x) : limbs{}{
+        uint64_t fill = x.is_negative() ? ~uint64_t{0} : 0;
+        for(size_t i = 0; i < limb_count; i++) limbs[i] = i < x.limb_count ? x.limbs[i] : fill;
+    }
+
+    template<typename I> requires (std::is_integral_v<I> and not std::is_same_v<I, bool>)
+    explicit constexpr operator I() const{
+        return static_cast<I>(limbs[0]);
+    }
+
+    explicit constexpr operator bool() const{
+        for(auto limb : limbs){
+            if(limb != 0) return true;
+        }
+        return false;
+    }
+
+    explicit constexpr operator double() const{
+        wide_int magnitude = is_negative() ? -*this : *this;
+        double result = 0.0;
+        for(size_t i = limb_count; i-- > 0;) result = result * 18446744073709551616.0 + static_cast<double>(magnitude.limbs[i]);
+        return is_negative() ? -result : result;
+    }
+
+    constexpr bool is_negative() const{
+        if constexpr(is_signed_int){
+            return (limbs[limb_count - 1] >> 63) != 0;
+        }
+        else{
+            return false;
+        }
+    }
+
+    constexpr int countl_zero() const{
+        for(size_t i = limb_count; i-- > 0;){
+            if(limbs[i] != 0) return static_cast<int>((limb_count - 1 - i) * 64) + std::countl_zero(limbs[i]);
+        }
+        return static_cast<int>(bits);
+    }
+
+    constexpr wide_int operator-() const{
+        wide_int result = ~*this;
+        return ++result;
+    }
+
+    constexpr wide_int operator+() const{
+        return *this;
+    }
+
+    constexpr wide_int operator~() const{
+        wide_int result;
+        for(size_t i = 0; i < limb_count; i++) result.limbs[i] = ~limbs[i];
+        return result;
+    }
+
+    constexpr wide_int& operator++(){
+        for(auto& limb : limbs){
+            if(++limb != 0) break;
+        }
+        return *this;
+    }
+
+    constexpr wide_int& operator--(){
+        for(auto& limb : limbs){
+            if(limb-- != 0) break;
+        }
+        return *this;
+    }
+
+    constexpr wide_int operator++(int){
+        wide_int old = *this;
+        ++*this;
+        return old;
+    }
+
+    constexpr wide_int operator--(int){
+        wide_int old = *this;
+        --*this;
+        return old;
+    }
+
+    constexpr wide_int& operator+=(const wide_int& other){
+        detail::add_limbs(limbs.data(), limb_count, other.limbs.data(), limb_count);
+        return *this;
+    }
+
+    constexpr wide_int& operator-=(const wide_int& other){
+        detail::sub_limbs(limbs.data(), limb_count, other.limbs.data(), limb_count);
+        return *this;
+    }
+
+    constexpr wide_int& operator*=(const wide_int& other){
+        limbs = detail::truncated_multiply(limbs, other.limbs);
+        return *this;
+    }
+
+    constexpr wide_int& operator/=(const wide_int& other){
+        wide_int remainder;
+        divide(*this, other, *this, remainder);
+        return *this;
+    }
+
+    constexpr wide_int& operator%=(const wide_int& other){
+        wide_int quotient;
+        divide(*this, other, quotient, *this);
+        return *this;
+    }
+
+    constexpr wide_int& operator&=(const wide_int& other){
+        for(size_t i = 0; i < limb_count; i++) limbs[i] &= other.limbs[i];
+        return *this;
+    }
+
+    constexpr wide_int& operator|=(const wide_int& other){
+        for(size_t i = 0; i < limb_count; i++) limbs[i] |= other.limbs[i];
+        return *this;
+    }
+
+    constexpr wide_int& operator^=(const wide_int& other){
+        for(size_t i = 0; i < limb_count; i++) limbs[i] ^= other.limbs[i];
+        return *this;
+    }
+
+    template<typename I> requires std::is_integral_v<I>
+    constexpr wide_int& operator<<=(I shift){
+        size_t s = static_cast<size_t>(shift);
+        size_t limb_shift = s / 64;
+        size_t bit_shift = s % 64;
+        wide_int result;
+        for(size_t i = limb_count; i-- > 0;){
+            uint64_t current = i >= limb_shift ? limbs[i - limb_shift] : 0;
+            uint64_t lower = i >= limb_shift + 1 ? limbs[i - limb_shift - 1] : 0;
+            result.limbs[i] = bit_shift ? (current << bit_shift) | (lower >> (64 - bit_shift)) : current;
+        }
+        *this = result;
+        return *this;
+    }
+
+    template<typename I> requires std::is_integral_v<I>
+    constexpr wide_int& operator>>=(I shift){
+        size_t s = static_cast<size_t>(shift);
+        size_t limb_shift = s / 64;
+        size_t bit_shift = s % 64;
+        uint64_t fill = is_negative() ? ~uint64_t{0} : 0;
+        wide_int result;
+        for(size_t i = 0; i < limb_count; i++){
+            uint64_t current = i + limb_shift < limb_count ? limbs[i + limb_shift] : fill;
+            uint64_t upper = i + limb_shift + 1 < limb_count ? limbs[i + limb_shift + 1] : fill;
+            result.limbs[i] = bit_shift ? (current >> bit_shift) | (upper << (64 - bit_shift)) : current;
+        }
+        *this = result;
+        return *this;
+    }
+
+    friend constexpr wide_int operator+(wide_int a, const wide_int& b){
+        return a += b;
+    }
+
+    friend constexpr wide_int operator-(wide_int a, const wide_int& b){
+        return a -= b;
+    }
+
+    friend constexpr wide_int operator*(wide_int a, const wide_int& b){
+        return a *= b;
+    }
+
+    friend constexpr wide_int operator/(wide_int a, const wide_int& b){
+        return a /= b;
+    }
+
+    friend constexpr wide_int operator%(wide_int a, const wide_int& b){
+        return a %= b;
+    }
+
+    friend constexpr wide_int operator&(wide_int a, const wide_int& b){
+        return a &= b;
+    }
+
+    friend constexpr wide_int operator|(wide_int a, const wide_int& b){
+        return a |= b;
+    }
+
+    friend constexpr wide_int operator^(wide_int a, const wide_int& b){
+        return a ^= b;
+    }
+
+    template<typename I> requires std::is_integral_v<I>
+    friend constexpr wide_int operator<<(wide_int a, I shift){
+        return a <<= shift;
+    }
+
+    template<typename I> requires std::is_integral_v<I>
+    friend constexpr wide_int operator>>(wide_int a, I shift){
+        return a >>= shift;
+    }
+
+    friend constexpr bool operator==(const wide_int& a, const wide_int& b){
+        return a.limbs == b.limbs;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(const wide_int& a, const wide_int& b){
+        if constexpr(is_signed_int){
+            bool a_negative = a.is_negative();
+            bool b_negative = b.is_negative();
+            if(a_negative != b_negative) return a_negative ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        //with equal signs two's complement orders like the unsigned limbs
+        for(size_t i = limb_count; i-- > 0;){
+            if(a.limbs[i] != b.limbs[i]) return a.limbs[i] <=> b.limbs[i];
+        }
+        return std::strong_ordering::equal;
+    }
+
+private:
+    //truncating division like the builtin integers, the remainder has the sign of a
+    constexpr static void divide(const wide_int& a, const wide_int& b, wide_int& quotient, wide_int& remainder){
+        bool a_negative = a.is_negative();
+        bool b_negative = b.is_negative();
+        wide_int a_magnitude = a_negative ? -a : a;
+        wide_int b_magnitude = b_negative ? -b : b;
+        detail::divide_limbs(a_magnitude.limbs, b_magnitude.limbs, quotient.limbs, remainder.limbs);
+        if(a_negative != b_negative) quotient = -quotient;
+        if(a_negative) remainder = -remainder;
+    }
+};
+
+template<size_t bits>
+using wide_uint = wide_int<bits, false>;
+
+template<size_t bits, bool is_signed_int>
+constexpr inline wide_int<bits, is_signed_int> abs(const wide_int<bits, is_signed_int>& x){
+    return x.is_negative() ? -x : x;
+}
+
+//number of leading zero bits, for builtin integers and wide_int alike
+template<typename T> requires std::is_integral_v<T>
+constexpr inline int leading_zeros(T x){
+    return std::countl_zero(static_cast<std::make_unsigned_t<T>>(x));
+}
+
+template<size_t bits, bool is_signed_int>
+constexpr inline int leading_zeros(const wide_int<bits, is_signed_int>& x){
+    return x.countl_zero();
+}
+
+
+/*
+    exact product at twice the width of the factors.
+    the limbs are multiplied as unsigned numbers, for negative factors the two's complement
+    correction a * b = ua * ub - 2^bits (b [a < 0] + a [b < 0]) is applied to the high half.
+*/
+constexpr inline wide_int<128> wide_product(int64_t a, int64_t b){
+    wide_int<128> result;
+    uint64_t high;
+    result.limbs[0] = detail::multiply_limbs(static_cast<uint64_t>(a), static_cast<uint64_t>(b), high);
+    if(a < 0) high -= static_cast<uint64_t>(b);
+    if(b < 0) high -= static_cast<uint64_t>(a);
+    result.limbs[1] = high;
+    return result;
+}
+
+constexpr inline wide_uint<128> wide_product(uint64_t a, uint64_t b){
+    wide_uint<128> result;
+    result.limbs[0] = detail::multiply_limbs(a, b, result.limbs[1]);
+    return result;
+}
+
+template<size_t bits, bool is_signed_int>
+constexpr inline wide_int<2 * bits, is_signed_int> wide_product(const wide_int<bits, is_signed_int>& a, const wide_int<bits, is_signed_int>& b){
+    constexpr size_t n = wide_int<bits, is_signed_int>::limb_count;
+    wide_int<2 * bits, is_signed_int> result;
+    result.limbs = detail::multiply_full(a.limbs, b.limbs);
+    if(a.is_negative()) detail::sub_limbs(result.limbs.data() + n, n, b.limbs.data(), n);
+    if(b.is_negative()) detail::sub_limbs(result.limbs.data() + n, n, a.limbs.data(), n);
+    return result;
+}
+
+}//namespace fixed_point
+
+
+template<size_t bits, bool is_signed_int>
+class std::numeric_limits<fixed_point::wide_int<bits, is_signed_int>>{
+    using type = fixed_point::wide_int<bits, is_signed_int>;
+
+public:
+    constexpr static bool is_specialized = true;
+    constexpr static bool is_signed = is_signed_int;
+    constexpr static bool is_integer = true;
+    constexpr static bool is_exact = true;
+    constexpr static bool has_infinity = false;
+    constexpr static bool has_quiet_NaN = false;
+    constexpr static bool has_signaling_NaN = false;
+    constexpr static bool is_bounded = true;
+    constexpr static bool is_modulo = not is_signed_int;
+    constexpr static int radix = 2;
+    constexpr static int digits = static_cast<int>(bits) - (is_signed_int ? 1 : 0);
+    //digits * log10(2)
+    constexpr static int digits10 = static_cast<int>(static_cast<int64_t>(digits) * 30103 / 100000);
+
+    constexpr static type min() noexcept{
+        return is_signed_int ? type(1) << (bits - 1) : type(0);
+    }
+
+    constexpr static type lowest() noexcept{
+        return min();
+    }
+
+    constexpr static type max() noexcept{
+        return ~min();
+    }
+};
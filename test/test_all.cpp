@@ -2,11 +2,55 @@
 
 #include "test_arithmetic.hpp"
 #include "test_ctor.hpp"
+#include "test_profiler.hpp"
+#include "test_range.hpp"
+#include "test_linalg.hpp"
+#include "test_fir.hpp"
+#include "test_iir.hpp"
+#include "test_fft.hpp"
+#include "test_complex.hpp"
+#include "test_gemm.hpp"
+#include "test_packed.hpp"
+#include "test_file.hpp"
+#include "test_convert.hpp"
+#include "test_dynamic.hpp"
+#include "test_wide_int.hpp"
+#include "test_atomic.hpp"
+#include "test_sort.hpp"
+#include "test_random.hpp"
+#include "test_stats.hpp"
+#include "test_interpolation.hpp"
+#include "test_polynomial.hpp"
+#include "test_parallel.hpp"
+#include "test_counting.hpp"
+#include "test_requantize.hpp"
 
 int main(){
     bool all_passed = true;
     all_passed &= test_arithmetic();
     all_passed &= test_ctor();
+    all_passed &= test_profiler();
+    all_passed &= test_range();
+    all_passed &= test_linalg();
+    all_passed &= test_fir();
+    all_passed &= test_iir();
+    all_passed &= test_fft();
+    all_passed &= test_complex();
+    all_passed &= test_gemm();
+    all_passed &= test_packed();
+    all_passed &= test_file();
+    all_passed &= test_convert();
+    all_passed &= test_dynamic();
+    all_passed &= test_wide_int();
+    all_passed &= test_atomic();
+    all_passed &= test_sort();
+    all_passed &= test_random();
+    all_passed &= test_stats();
+    all_passed &= test_interpolation();
+    all_passed &= test_polynomial();
+    all_passed &= test_parallel();
+    all_passed &= test_counting();
+    all_passed &= test_requantize();
     
     
     if(!all_passed){
@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "test_atomic.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_atomic.hpp"
+
+using namespace fixed_point;
+
+template<typename F>
+void run_threads(size_t count, F&& body){
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < count; t++) threads.emplace_back([&body, t](){ body(t); });
+    for(auto& th : threads) th.join();
+}
+
+bool test_atomic(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    constexpr size_t threads = 8;
+    constexpr int iterations = 20000;
+    
+    {
+        passed = true;
+        using fp = fixed<int32_t, 16>;
+        static_assert(atomic_fixed<int32_t, 16>::is_always_lock_free and atomic_fixed<int64_t, 32>::is_always_lock_free);
+        atomic_fixed<int32_t, 16> sum;
+        atomic_fixed<int32_t, 16> maximum(fp(-1000));
+        atomic_fixed<int32_t, 16> minimum(fp(1000));
+        run_threads(threads, [&](size_t t){
+            for(int i = 0; i < iterations; i++){
+                sum.fetch_add(fp(0.25_fixp_t), std::memory_order_relaxed);
+                sum.fetch_sub(fp(0.125_fixp_t), std::memory_order_relaxed);
+                fp x = fp(static_cast<int32_t>(t * 10 + i % 7)) - fp(40);
+                maximum.fetch_max(x);
+                minimum.fetch_min(x);
+            }
+        });
+        passed &= sum.load() == fp(static_cast<int32_t>(threads * iterations / 8));
+        passed &= maximum.load() == fp(static_cast<int32_t>((threads - 1) * 10 + 6 - 40));
+        passed &= minimum.load() == fp(-40);
+        passed &= maximum.fetch_max(fp(-100)) == maximum.load();
+        
+        atomic_fixed<int64_t, 32> wide(fixed<int64_t, 32>(1));
+        wide += fixed<int64_t, 32>(0.5_fixp_t);
+        fixed<int64_t, 32> expected = 1;
+        passed &= not wide.compare_exchange_strong(expected, fixed<int64_t, 32>(7)) and expected == fixed<int64_t, 32>(1.5_fixp_t);
+        passed &= wide.compare_exchange_strong(expected, fixed<int64_t, 32>(7)) and wide.load() == fixed<int64_t, 32>(7);
+        if(!passed) log_msg("failed atomic fixed test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using fp = fixed<int64_t, 32>;
+        sharded_fixed_accumulator<int64_t, 32> acc;
+        run_threads(threads, [&](size_t t){
+            for(int i = 0; i < iterations; i++){
+                acc.add(fp(static_cast<int64_t>(t)));
+                acc.sub(fp(0.5_fixp_t));
+            }
+        });
+        //sum over t of (t - 0.5) * iterations
+        passed &= acc.value() == fp(static_cast<int64_t>((threads * (threads - 1) / 2) * iterations - threads * iterations / 2));
+        acc.reset();
+        passed &= acc.value() == fp(0);
+        if(!passed) log_msg("failed sharded accumulator test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using fp = fixed<int16_t, 8>;
+        using histogram = concurrent_histogram<int16_t, 8, 4>;
+        //16 buckets of 16 units each, ordered from -128 up
+        passed &= histogram::bucket_of(fp(-128)) == 0 and histogram::bucket_of(fp(-1)) == 7;
+        passed &= histogram::bucket_of(fp(0)) == 8 and histogram::bucket_of(fp(127)) == 15;
+        passed &= histogram::lower_bound(0) == fp(-128) and histogram::lower_bound(9) == fp(16);
+        
+        histogram h;
+        std::vector<fp> values(1000);
+        for(size_t i = 0; i < values.size(); i++) values[i].v = static_cast<int16_t>(i * 61 - 30000);
+        run_threads(threads, [&](size_t t){
+            if(t % 2 == 0){
+                h.add(std::span<const fp>(values));
+            }
+            else{
+                for(auto x : values) h.add(x);
+            }
+        });
+        passed &= h.total() == threads * values.size();
+        auto counts = h.snapshot();
+        for(size_t b = 0; b < histogram::bucket_count; b++){
+            uint64_t expected = 0;
+            for(auto x : values) expected += histogram::bucket_of(x) == b;
+            passed &= counts[b] == expected * threads;
+        }
+        h.reset();
+        passed &= h.total() == 0;
+        
+        //small spans reuse the scratch counts of the thread, which are shared with histograms of more buckets
+        concurrent_histogram<int16_t, 8, 12> fine;
+        for(size_t start = 0; start < values.size(); start += 3){
+            auto part = std::span<const fp>(values).subspan(start, std::min<size_t>(3, values.size() - start));
+            fine.add(part);
+            h.add(part);
+        }
+        passed &= fine.total() == values.size() and h.total() == values.size();
+        for(size_t b = 0; b < histogram::bucket_count; b++){
+            uint64_t expected = 0;
+            for(auto x : values) expected += histogram::bucket_of(x) == b;
+            passed &= h.count(b) == expected;
+        }
+        for(auto x : values) passed &= fine.count(fine.bucket_of(x)) >= 1;
+        if(!passed) log_msg("failed concurrent histogram test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
@@ -0,0 +1,132 @@
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "test_complex.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_complex.hpp"
+
+using namespace fixed_point;
+
+using fixp = fixed<int32_t, 16>;
+using cfix = complex_fixed<int32_t, 16>;
+
+bool test_complex_scalar(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        cfix a{1.5_fixp_t, -2.0_fixp_t};
+        cfix b{0.5_fixp_t, 3.0_fixp_t};
+        //(1.5 - 2i)(0.5 + 3i) = 0.75 + 6 + (4.5 - 1)i
+        passed &= a * b == cfix{6.75_fixp_t, 3.5_fixp_t};
+        passed &= multiply_gauss(a, b) == a * b;
+        passed &= conj_multiply(a, b) == a * conj(b);
+        passed &= magnitude_squared(a) == fixp(6.25_fixp_t);
+        //two min() components give 2^63, which only fits unsigned
+        const auto lowest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min());
+        passed &= wide_magnitude_squared(cfix{lowest, lowest}) == uint64_t{1} << 63;
+        passed &= magnitude_squared(cfix{lowest, lowest}).v == std::numeric_limits<int32_t>::max();
+        std::array<fixp, 1> low_re = {lowest};
+        std::array<fixp, 1> split_magnitude;
+        complex_magnitude_squared_split<int32_t, 16>(low_re, low_re, split_magnitude);
+        passed &= split_magnitude[0].v == std::numeric_limits<int32_t>::max();
+        passed &= a * fixp(2) == cfix{3, -4};
+        passed &= a + b == cfix{2, 1};
+        passed &= a - b == cfix{1, -5};
+        if(!passed) log_msg("failed 'complex arithmetic' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //with 2 fractional bits, four truncated products give 0.5 + 0.5 = 1.0, rounding the exact 1.125 once gives 1.25
+        using c8 = complex_fixed<int8_t, 2>;
+        c8 a{fp_from_bits<int8_t, 2>(3), fp_from_bits<int8_t, 2>(3)};
+        c8 b{fp_from_bits<int8_t, 2>(3), fp_from_bits<int8_t, 2>(-3)};
+        auto p = a * b; //(0.75 + 0.75i)(0.75 - 0.75i) = 1.125
+        passed &= p.re.v == 5 and p.im.v == 0;
+        passed &= multiply_gauss(a, b) == p;
+        if(!passed) log_msg("failed 'complex single rounding' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //min() * min() + min() * min() is 2^63 in Q31, one past int64_t, the sum saturates instead of overflowing
+        using q31 = fixed<int32_t, 31>;
+        using cq31 = complex_fixed<int32_t, 31>;
+        constexpr int32_t lo = std::numeric_limits<int32_t>::min();
+        constexpr int32_t hi = std::numeric_limits<int32_t>::max();
+        const q31 m = fp_from_bits<int32_t, 31>(lo);
+        const cq31 c{m, m};
+        passed &= c * c == cq31{fp_from_bits<int32_t, 31>(0), fp_from_bits<int32_t, 31>(hi)};
+        passed &= conj_multiply(c, c) == cq31{fp_from_bits<int32_t, 31>(hi), fp_from_bits<int32_t, 31>(0)};
+        passed &= (c * m).re.v == hi and (c * m).im.v == hi;
+        std::array<q31, 1> re = {m}, im = {m}, out_re, out_im;
+        complex_multiply_split<int32_t, 31>(re, im, re, im, out_re, out_im);
+        passed &= out_re[0].v == 0 and out_im[0].v == hi;
+        complex_conj_multiply_split<int32_t, 31>(re, im, re, im, out_re, out_im);
+        passed &= out_re[0].v == hi and out_im[0].v == 0;
+        //the same through the 128 bit accumulator of 64 bit components
+        using c64 = complex_fixed<int64_t, 63>;
+        const auto m64 = fp_from_bits<int64_t, 63>(std::numeric_limits<int64_t>::min());
+        passed &= (c64{m64, m64} * c64{m64, m64}).im.v == std::numeric_limits<int64_t>::max();
+        passed &= conj_multiply(c64{m64, m64}, c64{m64, m64}).re.v == std::numeric_limits<int64_t>::max();
+        if(!passed) log_msg("failed 'complex min() components' test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_complex_batch(){
+    constexpr size_t n = 50;
+    std::vector<cfix> a(n), b(n), out(n), out_gauss(n), out_conj(n);
+    std::vector<fixp> a_re(n), a_im(n), b_re(n), b_im(n), o_re(n), o_im(n), mag(n), mag_split(n);
+    for(size_t i = 0; i < n; i++){
+        int k = static_cast<int>(i);
+        a[i] = {fp_from_bits<int32_t, 16>(k * 12345 - 300000), fp_from_bits<int32_t, 16>(k * -7777 + 99999)};
+        b[i] = {fp_from_bits<int32_t, 16>(k * 999 + 5), fp_from_bits<int32_t, 16>(k * 31337 - 700000)};
+        a_re[i] = a[i].re; a_im[i] = a[i].im;
+        b_re[i] = b[i].re; b_im[i] = b[i].im;
+    }
+    
+    complex_multiply<int32_t, 16>(a, b, out);
+    complex_multiply_gauss<int32_t, 16>(a, b, out_gauss);
+    complex_conj_multiply<int32_t, 16>(a, b, out_conj);
+    complex_magnitude_squared<int32_t, 16>(a, mag);
+    
+    bool passed = true;
+    passed &= out == out_gauss;
+    for(size_t i = 0; i < n; i++){
+        passed &= out[i] == a[i] * b[i];
+        passed &= out_conj[i] == a[i] * conj(b[i]);
+        passed &= mag[i] == magnitude_squared(a[i]);
+    }
+    
+    complex_multiply_split<int32_t, 16>(a_re, a_im, b_re, b_im, o_re, o_im);
+    for(size_t i = 0; i < n; i++) passed &= cfix{o_re[i], o_im[i]} == out[i];
+    complex_conj_multiply_split<int32_t, 16>(a_re, a_im, b_re, b_im, o_re, o_im);
+    for(size_t i = 0; i < n; i++) passed &= cfix{o_re[i], o_im[i]} == out_conj[i];
+    complex_magnitude_squared_split<int32_t, 16>(a_re, a_im, mag_split);
+    passed &= mag == mag_split;
+    return passed;
+}
+
+bool test_complex(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_complex_scalar();
+    if(!passed) log_msg("failed complex scalar test!");
+    all_passed &= passed;
+    
+    passed = test_complex_batch();
+    if(!passed) log_msg("failed complex batch test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
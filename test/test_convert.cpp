@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_convert.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_convert.hpp"
+
+using namespace fixed_point;
+
+bool test_convert(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        using q16 = fixed<int32_t, 16>;
+        //1.75 + 1/256 + 1/512 is exactly half way between two steps of 1/256
+        q16 a = fp_from_bits<int32_t, 16>((7 << 14) + 256 + 128);
+        passed &= fixed_cast<int16_t, 8>(a).v == (7 << 6) + 2;
+        passed &= fixed_cast<int16_t, 8, rounding_mode::truncate>(a).v == (7 << 6) + 1;
+        passed &= fixed_cast<int16_t, 8>(-a).v == -((7 << 6) + 1);
+        passed &= fixed_cast<int16_t, 8, rounding_mode::truncate>(-a).v == -((7 << 6) + 2);
+        //the truncating cast matches the explicit conversion operator
+        passed &= fixed_cast<int16_t, 8, rounding_mode::truncate, overflow_mode::wrap>(a) == static_cast<fixed<int16_t, 8>>(a);
+        if(!passed) log_msg("failed convert rounding test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using q16 = fixed<int32_t, 16>;
+        q16 big = 1000;
+        passed &= fixed_cast<int16_t, 8>(big).v == 32767;
+        passed &= fixed_cast<int16_t, 8>(-big).v == -32768;
+        passed &= fixed_cast<int16_t, 8, rounding_mode::nearest, overflow_mode::wrap>(big).v == static_cast<int16_t>(1000 << 8);
+        passed &= fixed_cast<uint8_t, 4>(-big).v == 0;
+        passed &= fixed_cast<uint8_t, 4>(fixed<int32_t, 16>(3)).v == 48;
+        //widening into more fractional bits saturates instead of losing the top bits
+        passed &= fixed_cast<int32_t, 30>(big).v == std::numeric_limits<int32_t>::max();
+        passed &= fixed_cast<int32_t, 30>(fixed<int8_t, 0>(-1)).v == -(1 << 30);
+        passed &= fixed_cast<int32_t, 32>(fixed<uint32_t, 0>(4000000000u)).v == std::numeric_limits<int32_t>::max();
+        passed &= fixed_cast<int32_t, 16>(fixed<int8_t, 4>(-128 >> 4)) == fixed<int32_t, 16>(-8);
+        if(!passed) log_msg("failed convert saturation test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        std::vector<fixed<int32_t, 16>> wide(100);
+        for(size_t i = 0; i < wide.size(); i++) wide[i].v = static_cast<int32_t>((i * 2654435761u) >> 7) - (1 << 24);
+        std::vector<fixed<int16_t, 8>> narrow(wide.size());
+        convert<int16_t, 8>(std::span<const fixed<int32_t, 16>>(wide), std::span(narrow));
+        std::vector<fixed<int32_t, 16>> back(wide.size());
+        convert<int32_t, 16>(std::span<const fixed<int16_t, 8>>(narrow), std::span(back));
+        for(size_t i = 0; i < wide.size(); i++){
+            passed &= narrow[i] == fixed_cast<int16_t, 8>(wide[i]);
+            passed &= back[i].v == static_cast<int32_t>(narrow[i].v) << 8;
+        }
+        if(!passed) log_msg("failed convert span test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
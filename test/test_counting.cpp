@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_counting.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_counting.hpp"
+
+using namespace fixed_point;
+
+//the same kernel runs on fixed and counting_fixed
+template<typename F>
+F counting_kernel(const std::vector<F>& xs, F a, F b){
+    F acc = 0;
+    for(const auto& x : xs){
+        F y = a * x + b;
+        if(y < F(0)) y = -y;
+        acc += y / a;
+    }
+    return acc;
+}
+
+bool test_counting(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    using plain_t = fixed<int32_t, 16>;
+    using counted_t = counting_fixed<int32_t, 16>;
+    std::vector<plain_t> plain_xs;
+    std::vector<counted_t> counted_xs;
+    for(int i = 0; i < 10; i++){
+        plain_xs.push_back(fp_from_bits<int32_t, 16>(i * 40503 - 200000));
+        counted_xs.push_back(counted_t(fp_from_bits<int32_t, 16>(i * 40503 - 200000)));
+    }
+    
+    passed = true;
+    {
+        op_counter counter;
+        plain_t expected = counting_kernel(plain_xs, plain_t(1.75_fixp_t), plain_t(-0.5_fixp_t));
+        counted_t result;
+        {
+            counting_scope scope("affine", counter);
+            result = counting_kernel(counted_xs, counted_t(1.75_fixp_t), counted_t(-0.5_fixp_t));
+        }
+        passed &= result.f.v == expected.v;
+        
+        const op_counts& c = counter.kernel("affine");
+        int negative = 0;
+        for(auto x : plain_xs) negative += (plain_t(1.75_fixp_t) * x + plain_t(-0.5_fixp_t)).v < 0;
+        passed &= c[fixed_op::multiply] == 10;
+        passed &= c[fixed_op::fast_divide] == 10;
+        passed &= c[fixed_op::compare] == 10;
+        passed &= c[fixed_op::add] == uint64_t(20 + negative);
+        passed &= c[fixed_op::divide] == 0 and c[fixed_op::sqrt_iteration] == 0;
+        passed &= c.total() == uint64_t(50 + negative);
+        passed &= counter.kernels().size() == 1;
+        
+        //nothing is recorded outside of a scope
+        result = result * result;
+        passed &= counter.kernel("affine").total() == uint64_t(50 + negative);
+    }
+    if(!passed) log_msg("failed counting kernel test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        op_counter counter;
+        {
+            counting_scope outer("outer", counter);
+            counted_t x = 2.25_fixp_t;
+            counted_t y = sqrt(x);
+            passed &= y.f.v == sqrt(plain_t(2.25_fixp_t)).v;
+            {
+                counting_scope inner("inner", counter);
+                y = correctly_rounded_division(y, x);
+                y = clamp(y, counted_t(0), counted_t(1));
+            }
+            passed &= y.to_int() == 0;
+            y = counting_from_float<int32_t, 16>(0.5f);
+            passed &= y.f.v == 1 << 15;
+        }
+        const op_counts& outer = counter.kernel("outer");
+        const op_counts& inner = counter.kernel("inner");
+        passed &= outer[fixed_op::sqrt_iteration] == 5 and outer[fixed_op::fast_divide] == 4 and outer[fixed_op::divide] == 2;
+        passed &= outer[fixed_op::convert] == 1 and outer[fixed_op::float_conversion] == 1;
+        passed &= inner[fixed_op::divide] == 1 and inner[fixed_op::compare] == 2 and inner.total() == 3;
+        
+        passed &= inner.cycles(x86_64_cycles) == 45 + 2;
+        passed &= inner.division_cycles(cortex_m0_cycles) == 450;
+        passed &= outer.cycles(cortex_m4_cycles) > outer.cycles(x86_64_cycles);
+        
+        op_counts sum = outer;
+        sum += inner;
+        passed &= sum.total() == outer.total() + inner.total();
+        
+        counter.clear();
+        passed &= counter.kernels().empty();
+    }
+    if(!passed) log_msg("failed counting scope test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_dynamic.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_dynamic.hpp"
+
+using namespace fixed_point;
+
+bool test_dynamic(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        //the index table covers every valid format exactly once
+        for(size_t i = 0; i < format_count; i++){
+            passed &= format_from_index(i).valid() and format_index(format_from_index(i)) == i;
+        }
+        passed &= format_index(format_of<int16_t, 8>()) == unsigned_format_count + 8 + 8;
+        passed &= not fixed_format{3, true, 0}.valid() and not fixed_format{1, true, 8}.valid() and not fixed_format{1, false, 9}.valid();
+        //unsigned formats without whole bits, like pixels in [0, 1)
+        passed &= fixed_format{1, false, 8}.valid() and fixed_format{2, false, 16}.valid() and fixed_format{4, false, 32}.valid();
+        passed &= format_from_index(format_index(format_of<uint8_t, 8>())) == format_of<uint8_t, 8>();
+        
+        size_t bytes = dispatch_format({2, false, 5}, [](auto tag){
+            using fixed_t = decltype(tag);
+            return sizeof(typename fixed_t::int_type) * 100 + std::is_signed_v<typename fixed_t::int_type> * 10 + fixed_t::frac_bits();
+        });
+        passed &= bytes == 205;
+        
+        dynamic_fixed_array pixels(format_of<uint8_t, 8>(), 4);
+        pixels.set(1, dynamic_fixed::from(fixed<int32_t, 16>(0.5_fixp_t)));
+        pixels.set(2, dynamic_fixed::from(fixed<int32_t, 16>(2)));
+        passed &= pixels.get(1).bits == 128 and pixels.get(2).bits == 255 and pixels.get(1).to_double() == 0.5;
+        passed &= pixels.get(1).to<uint16_t, 16>().v == 32768;
+        if(!passed) log_msg("failed dynamic dispatch test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        auto d = dynamic_fixed::from(fixed<int16_t, 8>(-3));
+        passed &= d.format == format_of<int16_t, 8>() and d.bits == -768;
+        passed &= d.to<int32_t, 16>() == fixed<int32_t, 16>(-3);
+        passed &= d.to<uint8_t, 4>().v == 0;
+        passed &= d.to_double() == -3.0;
+        if(!passed) log_msg("failed dynamic value test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        dynamic_fixed_array a({1, true, 4}, 50);
+        std::vector<fixed<int32_t, 16>> in(50);
+        for(size_t i = 0; i < in.size(); i++) in[i].v = static_cast<int32_t>(i) * 6000 - 100000;
+        a.assign(std::span<const fixed<int32_t, 16>>(in));
+        
+        auto view = a.view<int8_t, 4>();
+        passed &= view.has_value() and not a.view<int8_t, 3>().has_value() and not a.view<uint8_t, 4>().has_value();
+        if(view){
+            for(size_t i = 0; i < in.size(); i++) passed &= (*view)[i] == fixed_cast<int8_t, 4>(in[i]);
+        }
+        
+        std::vector<fixed<int16_t, 8>> out(50);
+        a.convert_to<int16_t, 8>(std::span(out));
+        for(size_t i = 0; i < in.size(); i++) passed &= out[i].v == static_cast<int16_t>(fixed_cast<int8_t, 4>(in[i]).v << 4);
+        
+        a.set(3, dynamic_fixed::from(fixed<int32_t, 16>(2)));
+        passed &= a.get(3).bits == 32 and a.get(3).format == a.format();
+        
+        //a kernel that runs on whatever the array holds
+        int64_t sum = 0;
+        a.visit([&sum](auto values){
+            for(auto x : values) sum += x.v;
+        });
+        int64_t expected = 0;
+        for(size_t i = 0; i < a.size(); i++) expected += a.get(i).bits;
+        passed &= sum == expected;
+        if(!passed) log_msg("failed dynamic array test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
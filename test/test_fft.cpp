@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "test_fft.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_fft.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction, size_t N>
+bool test_fft_against_dft(double tolerance){
+    using cfix = complex_fixed<T, fraction>;
+    std::vector<cfix> data(N);
+    std::vector<std::complex<double>> x(N);
+    uint32_t state = 987654321u;
+    auto next = [&](){
+        state = state * 1664525u + 1013904223u;
+        return static_cast<double>(state >> 8) / (1 << 24) * 1.8 - 0.9;
+    };
+    const double scale = std::ldexp(1.0, fraction);
+    for(size_t i = 0; i < N; i++){
+        data[i].re.v = static_cast<T>(std::lround(next() * scale));
+        data[i].im.v = static_cast<T>(std::lround(next() * scale));
+        x[i] = {data[i].re.v / scale, data[i].im.v / scale};
+    }
+    
+    int exponent = fixed_fft<T, fraction, N>::forward(std::span<cfix, N>(data));
+    
+    const double pi = 3.14159265358979323846;
+    double max_error = 0;
+    double max_magnitude = 0;
+    for(size_t k = 0; k < N; k++){
+        std::complex<double> sum = 0;
+        for(size_t n = 0; n < N; n++){
+            sum += x[n] * std::polar(1.0, -2 * pi * static_cast<double>((k * n) % N) / N);
+        }
+        std::complex<double> got{std::ldexp(data[k].re.v / scale, exponent), std::ldexp(data[k].im.v / scale, exponent)};
+        max_error = std::max(max_error, std::abs(got - sum));
+        max_magnitude = std::max(max_magnitude, std::abs(sum));
+    }
+    bool passed = max_error < tolerance * max_magnitude;
+    if(!passed) std::cout << "fft size " << N << " error " << max_error << " peak " << max_magnitude << std::endl;
+    return passed;
+}
+
+template<typename T, size_t fraction, size_t N>
+bool test_fft_round_trip(int max_lsb_error){
+    using cfix = complex_fixed<T, fraction>;
+    std::vector<cfix> data(N);
+    std::vector<cfix> original(N);
+    for(size_t i = 0; i < N; i++){
+        data[i].re.v = static_cast<T>(((i * 37) % 101) * 100 - 5000);
+        data[i].im.v = static_cast<T>(((i * 53) % 97) * 90 - 4000);
+    }
+    original = data;
+    int e1 = fixed_fft<T, fraction, N>::forward(std::span<cfix, N>(data));
+    int e2 = fixed_fft<T, fraction, N>::inverse(std::span<cfix, N>(data));
+    int shift = e1 + e2 - std::countr_zero(N);
+    bool passed = true;
+    for(size_t i = 0; i < N; i++){
+        double re = std::ldexp(static_cast<double>(data[i].re.v), shift);
+        double im = std::ldexp(static_cast<double>(data[i].im.v), shift);
+        passed &= std::abs(re - original[i].re.v) <= max_lsb_error;
+        passed &= std::abs(im - original[i].im.v) <= max_lsb_error;
+    }
+    return passed;
+}
+
+//constant full scale input, all energy ends up in bin 0 and must keep its sign
+template<typename T, size_t fraction, size_t N>
+bool test_fft_full_scale_dc(T value){
+    using cfix = complex_fixed<T, fraction>;
+    std::vector<cfix> data(N);
+    for(auto& x : data){
+        x.re.v = value;
+        x.im.v = value;
+    }
+    int exponent = fixed_fft<T, fraction, N>::forward(std::span<cfix, N>(data));
+    double expected = static_cast<double>(value) * N;
+    double tolerance = std::ldexp(4.0, exponent);
+    bool passed = std::abs(std::ldexp(static_cast<double>(data[0].re.v), exponent) - expected) <= tolerance;
+    passed &= std::abs(std::ldexp(static_cast<double>(data[0].im.v), exponent) - expected) <= tolerance;
+    for(size_t k = 1; k < N; k++){
+        passed &= std::abs(std::ldexp(static_cast<double>(data[k].re.v), exponent)) <= tolerance;
+        passed &= std::abs(std::ldexp(static_cast<double>(data[k].im.v), exponent)) <= tolerance;
+    }
+    return passed;
+}
+
+bool test_fft(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    passed &= test_fft_against_dft<int32_t, 24, 4>(1e-6);
+    passed &= test_fft_against_dft<int32_t, 24, 8>(1e-6);
+    passed &= test_fft_against_dft<int32_t, 24, 64>(1e-6);
+    passed &= test_fft_against_dft<int32_t, 24, 128>(1e-6);
+    passed &= test_fft_against_dft<int32_t, 24, 1024>(1e-6);
+    passed &= test_fft_against_dft<int16_t, 12, 256>(5e-3);
+    passed &= test_fft_against_dft<int16_t, 12, 512>(5e-3);
+    if(!passed) log_msg("failed fft against dft test!");
+    all_passed &= passed;
+    
+    passed = true;
+    passed &= test_fft_round_trip<int32_t, 16, 256>(1);
+    passed &= test_fft_round_trip<int32_t, 16, 2048>(1);
+    if(!passed) log_msg("failed fft round trip test!");
+    all_passed &= passed;
+    
+    passed = true;
+    passed &= test_fft_full_scale_dc<int16_t, 15, 8>(32767);
+    passed &= test_fft_full_scale_dc<int16_t, 15, 32>(32767);
+    passed &= test_fft_full_scale_dc<int16_t, 15, 32>(-32768);
+    passed &= test_fft_full_scale_dc<int16_t, 15, 16>(32767);
+    passed &= test_fft_full_scale_dc<int32_t, 31, 128>(2147483647);
+    passed &= test_fft_full_scale_dc<int32_t, 31, 512>(-2147483647 - 1);
+    if(!passed) log_msg("failed fft full scale test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+bool test_fft();
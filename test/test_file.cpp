@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "test_file.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_file.hpp"
+
+using namespace fixed_point;
+
+bool test_file(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    const std::string path = (std::filesystem::temp_directory_path() / "fixed_point_test_file.bin").string();
+    
+    std::vector<fixed<int16_t, 10>> values(1000);
+    for(size_t i = 0; i < values.size(); i++) values[i].v = static_cast<int16_t>(i * 37 - 15000);
+    
+    {
+        passed = true;
+        fixed_file_writer<int16_t, 10> writer;
+        passed &= writer.open(path);
+        //streamed in uneven chunks
+        std::span<const fixed<int16_t, 10>> all(values);
+        passed &= writer.write(all.first(300));
+        passed &= writer.write(all.subspan(300, 0));
+        passed &= writer.write(all.subspan(300));
+        passed &= writer.size() == 1000;
+        passed &= writer.close();
+        
+        mapped_fixed_file file;
+        passed &= file.open(path);
+        auto header = file.header();
+        passed &= header.count == 1000 and header.width == 2 and header.is_signed == 1 and header.fraction == 10;
+        passed &= header.data_offset % 64 == 0;
+        auto view = file.view<int16_t, 10>();
+        passed &= view.has_value() and view->size() == values.size();
+        if(view){
+            for(size_t i = 0; i < values.size(); i++) passed &= (*view)[i] == values[i];
+        }
+        
+        mapped_fixed_file moved = std::move(file);
+        passed &= not file.is_open() and moved.is_open();
+        if(!passed) log_msg("failed file round trip test!");
+        all_passed &= passed;
+        
+        passed = true;
+        //the view is checked against the type it is requested as
+        passed &= not moved.view<int16_t, 9>().has_value();
+        passed &= not moved.view<uint16_t, 10>().has_value();
+        passed &= not moved.view<int32_t, 10>().has_value();
+        if(!passed) log_msg("failed file type check test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //truncated data and a broken magic are rejected
+        std::filesystem::resize_file(path, 64 + 999 * 2);
+        mapped_fixed_file file;
+        passed &= not file.open(path);
+        
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        std::fputc('X', f);
+        std::fclose(f);
+        std::filesystem::resize_file(path, 64 + 1000 * 2);
+        passed &= not file.open(path);
+        passed &= not file.open(path + ".missing");
+        if(!passed) log_msg("failed file validation test!");
+        all_passed &= passed;
+    }
+    
+    std::filesystem::remove(path);
+    return all_passed;
+}
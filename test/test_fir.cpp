@@ -0,0 +1,138 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_fir.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_fir.hpp"
+
+using namespace fixed_point;
+
+using sample = fixed<int16_t, 12>;
+using coeff = fixed<int16_t, 15>;
+
+constexpr std::array<coeff, 7> lowpass = {
+    coeff(0.03_fixp_t), coeff(0.11_fixp_t), coeff(0.22_fixp_t), coeff(0.28_fixp_t),
+    coeff(0.22_fixp_t), coeff(0.11_fixp_t), coeff(0.03_fixp_t)
+};
+
+std::vector<sample> test_signal(size_t n){
+    std::vector<sample> result(n);
+    uint32_t state = 12345;
+    for(auto& s : result){
+        state = state * 1664525u + 1013904223u;
+        s.v = static_cast<int16_t>(static_cast<int32_t>(state >> 16) - 32768) / 2;
+    }
+    return result;
+}
+
+bool test_fir_impulse_response(){
+    fir_filter<int16_t, 12, 15, 7> f(lowpass);
+    bool passed = true;
+    for(size_t i = 0; i < 10; i++){
+        sample y = f.process(sample(i == 0 ? 1 : 0));
+        int16_t expected = i < 7 ? static_cast<int16_t>((lowpass[i].v + 4) >> 3) : 0;
+        passed &= y.v == expected;
+    }
+    return passed;
+}
+
+bool test_fir_block_processing(){
+    auto x = test_signal(1000);
+    std::vector<sample> y_single(x.size());
+    std::vector<sample> y_block(x.size());
+    
+    fir_filter<int16_t, 12, 15, 7> a(lowpass);
+    fir_filter<int16_t, 12, 15, 7> b(lowpass);
+    for(size_t i = 0; i < x.size(); i++) y_single[i] = a.process(x[i]);
+    //mix block and single sample calls, the state has to carry over
+    b.process(std::span(x).subspan(0, 300), std::span(y_block).subspan(0, 300));
+    y_block[300] = b.process(x[300]);
+    y_block[301] = b.process(x[301]);
+    b.process(std::span(x).subspan(302), std::span(y_block).subspan(302));
+    
+    return y_single == y_block;
+}
+
+bool test_fir_decimator(){
+    auto x = test_signal(999);
+    std::vector<sample> y_full(x.size());
+    fir_filter<int16_t, 12, 15, 7> f(lowpass);
+    f.process(x, y_full);
+    
+    fir_decimator<int16_t, 12, 15, 7, 3> d(lowpass);
+    std::vector<sample> y(x.size() / 3 + 1);
+    size_t n = d.process(std::span(x).subspan(0, 500), y);
+    n += d.process(std::span(x).subspan(500), std::span(y).subspan(n));
+    
+    bool passed = n == 333;
+    for(size_t i = 0; i < n; i++) passed &= y[i] == y_full[3 * i];
+    return passed;
+}
+
+bool test_fir_interpolator(){
+    auto x = test_signal(200);
+    std::vector<sample> stuffed(x.size() * 2);
+    for(size_t i = 0; i < x.size(); i++){
+        stuffed[2 * i] = x[i];
+        stuffed[2 * i + 1] = sample(0);
+    }
+    std::vector<sample> y_full(stuffed.size());
+    fir_filter<int16_t, 12, 15, 7> f(lowpass);
+    f.process(stuffed, y_full);
+    
+    fir_interpolator<int16_t, 12, 15, 7, 2> up(lowpass);
+    std::vector<sample> y(stuffed.size());
+    up.process(x, y);
+    return y == y_full;
+}
+
+bool test_fir_headroom(){
+    //full scale 32 bit taps and samples, every product is close to 2^62 and the sum of 4 needs 128 bits
+    using wide_sample = fixed<int32_t, 16>;
+    using wide_coeff = fixed<int32_t, 16>;
+    const auto highest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::max());
+    const auto lowest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min());
+    std::array<wide_coeff, 4> h = {highest, highest, lowest, highest};
+    fir_filter<int32_t, 16, 16, 4, fir_accumulator_t<int32_t>> f(h);
+    bool passed = true;
+    std::vector<wide_sample> in = {highest, highest, highest, highest, lowest, lowest, lowest, lowest};
+    std::vector<wide_sample> out(in.size());
+    f.process(std::span<const wide_sample>(in), std::span(out));
+    //the taps sum to about 2^15, so full windows saturate to the sign of the input instead of wrapping
+    passed &= out[3] == highest and out[7] == lowest;
+    //products of about 2^62 which cancel, highest * (2 highest + 2 lowest) is -2 highest before the shift
+    std::array<wide_coeff, 4> same = {highest, highest, highest, highest};
+    fir_filter<int32_t, 16, 16, 4, fir_accumulator_t<int32_t>> sum(same);
+    std::vector<wide_sample> mixed = {highest, highest, lowest, lowest};
+    std::vector<wide_sample> sums(mixed.size());
+    sum.process(std::span<const wide_sample>(mixed), std::span(sums));
+    passed &= sums[3].v == -65536;
+    return passed;
+}
+
+bool test_fir(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_fir_impulse_response();
+    if(!passed) log_msg("failed fir impulse response test!");
+    all_passed &= passed;
+    
+    passed = test_fir_block_processing();
+    if(!passed) log_msg("failed fir block processing test!");
+    all_passed &= passed;
+    
+    passed = test_fir_decimator();
+    if(!passed) log_msg("failed fir decimator test!");
+    all_passed &= passed;
+    
+    passed = test_fir_interpolator();
+    if(!passed) log_msg("failed fir interpolator test!");
+    all_passed &= passed;
+    
+    passed = test_fir_headroom();
+    if(!passed) log_msg("failed fir headroom test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
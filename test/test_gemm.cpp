@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_gemm.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_gemm.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> test_matrix(size_t size, uint32_t seed){
+    std::vector<fixed<T, fraction>> result(size);
+    for(auto& x : result){
+        seed = seed * 1664525u + 1013904223u;
+        x.v = static_cast<T>(seed >> 24);
+    }
+    return result;
+}
+
+template<typename Ta, size_t fa, typename Tb, size_t fb, typename To, size_t fo>
+bool test_gemm_against_reference(size_t m, size_t n, size_t k, bool use_row_scale, size_t threads){
+    auto a = test_matrix<Ta, fa>(m * k, 1);
+    auto b = test_matrix<Tb, fb>(k * n, 2);
+    std::vector<fixed<int32_t, 30>> scale(m);
+    for(size_t i = 0; i < m; i++) scale[i].v = static_cast<int32_t>((1 << 29) + i * 1000003);
+    std::span<const fixed<int32_t, 30>> row_scale;
+    if(use_row_scale) row_scale = scale;
+    
+    std::vector<fixed<To, fo>> c(m * n);
+    gemm<Ta, fa, Tb, fb, To, fo>(a, b, c, m, n, k, row_scale, threads);
+    
+    std::vector<fixed<To, fo>> y(m);
+    std::vector<fixed<Tb, fb>> x(k);
+    for(size_t kk = 0; kk < k; kk++) x[kk] = b[kk * n];
+    gemv<Ta, fa, Tb, fb, To, fo>(a, x, y, m, k, row_scale, threads);
+    
+    bool passed = true;
+    for(size_t i = 0; i < m; i++){
+        for(size_t j = 0; j < n; j++){
+            int64_t acc = 0;
+            for(size_t kk = 0; kk < k; kk++) acc += static_cast<int64_t>(a[i * k + kk].v) * b[kk * n + j].v;
+            int shift = static_cast<int>(fa + fb) - static_cast<int>(fo);
+            if(use_row_scale){
+                acc *= scale[i].v;
+                shift += 30;
+            }
+            To expected = saturate<To>(rounding_shift_right(acc, shift));
+            passed &= c[i * n + j].v == expected;
+            if(j == 0) passed &= y[i].v == expected;
+        }
+    }
+    return passed;
+}
+
+bool test_gemm(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    passed &= test_gemm_against_reference<int8_t, 6, int8_t, 7, int8_t, 5>(37, 29, 600, false, 1);
+    passed &= test_gemm_against_reference<int8_t, 6, int8_t, 7, int16_t, 10>(37, 29, 600, false, 3);
+    passed &= test_gemm_against_reference<uint8_t, 8, int8_t, 7, int8_t, 4>(5, 70, 33, false, 2);
+    passed &= test_gemm_against_reference<int16_t, 12, int16_t, 12, int16_t, 8>(40, 33, 31, false, 4);
+    if(!passed) log_msg("failed gemm per tensor test!");
+    all_passed &= passed;
+    
+    passed = true;
+    passed &= test_gemm_against_reference<int8_t, 6, int8_t, 7, int8_t, 5>(37, 29, 600, true, 1);
+    passed &= test_gemm_against_reference<int16_t, 12, int16_t, 12, int16_t, 8>(65, 9, 31, true, 4);
+    if(!passed) log_msg("failed gemm per row test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        //an int64_t accumulator above 2^33 times a Q30 scale needs more than 64 bits
+        constexpr size_t k = 64;
+        using q15 = fixed<int16_t, 15>;
+        std::vector<q15> a(k, fp_from_bits<int16_t, 15>(std::numeric_limits<int16_t>::min()));
+        std::vector<q15> x(k, fp_from_bits<int16_t, 15>(std::numeric_limits<int16_t>::min()));
+        std::vector<fixed<int32_t, 30>> scale = {fp_from_bits<int32_t, 30>(1 << 29), fp_from_bits<int32_t, 30>(-(1 << 24))};
+        std::vector<fixed<int32_t, 0>> y(2);
+        std::vector<q15> a2(2 * k);
+        std::copy(a.begin(), a.end(), a2.begin());
+        std::copy(a.begin(), a.end(), a2.begin() + k);
+        gemv<int16_t, 15, int16_t, 15, int32_t, 0, int64_t>(a2, x, y, 2, k, scale);
+        //the sum is 64 * 2^30 with 30 fractional bits, i.e. 64, times 0.5 and times -2^-6
+        passed &= y[0].v == 32 and y[1].v == -1;
+        if(!passed) log_msg("failed gemm wide accumulator test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
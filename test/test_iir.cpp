@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#include "test_iir.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_iir.hpp"
+
+using namespace fixed_point;
+
+//second order lowpass, fc = fs / 50, q = 0.707
+constexpr double lp_b0 = 0.0036216815, lp_b1 = 0.007243363, lp_b2 = 0.0036216815;
+constexpr double lp_a1 = -1.8226949, lp_a2 = 0.8371816;
+
+template<typename T, size_t coeff_fraction>
+biquad_coefficients<T, coeff_fraction> lowpass_coefficients(){
+    auto q = [](double d){
+        return fp_from_bits<T, coeff_fraction>(static_cast<T>(std::llround(std::ldexp(d, coeff_fraction))));
+    };
+    return {q(lp_b0), q(lp_b1), q(lp_b2), q(lp_a1), q(lp_a2)};
+}
+
+std::vector<double> reference_lowpass(const std::vector<double>& x){
+    std::vector<double> y(x.size());
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for(size_t i = 0; i < x.size(); i++){
+        y[i] = lp_b0 * x[i] + lp_b1 * x1 + lp_b2 * x2 - lp_a1 * y1 - lp_a2 * y2;
+        x2 = x1; x1 = x[i];
+        y2 = y1; y1 = y[i];
+    }
+    return y;
+}
+
+bool test_iir_forms(){
+    using sample = fixed<int32_t, 16>;
+    constexpr size_t n = 500;
+    std::vector<double> xd(n);
+    std::vector<sample> x(n);
+    for(size_t i = 0; i < n; i++){
+        xd[i] = (i / 50) % 2 ? 1.0 : -0.5;
+        x[i] = fp_from_bits<int32_t, 16>(static_cast<int32_t>(xd[i] * 65536));
+    }
+    auto ref = reference_lowpass(xd);
+    
+    std::array c{lowpass_coefficients<int32_t, 28>()};
+    biquad_cascade<int32_t, 16, 28, 1, 1, biquad_form::direct_form_1> df1(c);
+    biquad_cascade<int32_t, 16, 28, 1, 1, biquad_form::transposed_form_2> tdf2(c);
+    std::vector<sample> y1(n), y2(n);
+    df1.process(x, y1);
+    tdf2.process(x, y2);
+    
+    bool passed = true;
+    for(size_t i = 0; i < n; i++){
+        //rounding the fed back output is amplified by the noise gain of the poles, 1 / (1 + a1 + a2) ~ 69
+        passed &= std::abs(y1[i].v - ref[i] * 65536) < 32;
+        passed &= std::abs(y2[i].v - ref[i] * 65536) < 32;
+        passed &= std::abs(y1[i].v - y2[i].v) <= 1;
+    }
+    
+    //full scale 32 bit input with Q30 coefficients, |b0| + |b1| + |b2| + |a1| + |a2| ~ 2.67 keeps the sums below 2^63
+    using q30 = biquad_coefficients<int32_t, 30>;
+    const q30 lowpass = lowpass_coefficients<int32_t, 30>();
+    passed &= biquad_cascade<int32_t, 16, 30, 1, 1>::fits_accumulator(lowpass);
+    q30 too_loud = lowpass;
+    too_loud.b0 = fp_from_bits<int32_t, 30>(std::numeric_limits<int32_t>::max());
+    too_loud.b1 = too_loud.b0;
+    passed &= not biquad_cascade<int32_t, 16, 30, 1, 1>::fits_accumulator(too_loud);
+    std::array full_c{lowpass};
+    biquad_cascade<int32_t, 16, 30, 1, 1, biquad_form::direct_form_1> full_df1(full_c);
+    biquad_cascade<int32_t, 16, 30, 1, 1, biquad_form::direct_form_1, noise_shaping::second_order> full_shaped(full_c);
+    biquad_cascade<int32_t, 16, 30, 1, 1, biquad_form::transposed_form_2> full_tdf2(full_c);
+    std::vector<sample> lowest(n, fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min()));
+    for(auto* f : {&y1, &y2}) std::fill(f->begin(), f->end(), sample{});
+    std::vector<sample> y3(n);
+    full_df1.process(lowest, y1);
+    full_shaped.process(lowest, y3);
+    full_tdf2.process(lowest, y2);
+    //the step response overshoots, so the outputs end up saturated at min() and never wrap to positive values
+    for(size_t i = 0; i < n; i++) passed &= y1[i].v <= 0 and y2[i].v <= 0 and y3[i].v <= 0;
+    passed &= y1.back() == lowest.back() and y2.back() == lowest.back() and y3.back() == lowest.back();
+    return passed;
+}
+
+bool test_iir_channels(){
+    using sample = fixed<int32_t, 16>;
+    constexpr size_t channels = 5;
+    constexpr size_t frames = 200;
+    std::array c{lowpass_coefficients<int32_t, 28>(), lowpass_coefficients<int32_t, 28>()};
+    
+    std::vector<sample> interleaved(channels * frames);
+    for(size_t i = 0; i < interleaved.size(); i++){
+        interleaved[i] = fp_from_bits<int32_t, 16>(static_cast<int32_t>((i * 7919) % 65536) - 32768);
+    }
+    biquad_cascade<int32_t, 16, 28, 2, channels, biquad_form::transposed_form_2> multi(c);
+    std::vector<sample> out(interleaved.size());
+    multi.process(interleaved, out);
+    
+    bool passed = true;
+    for(size_t ch = 0; ch < channels; ch++){
+        biquad_cascade<int32_t, 16, 28, 2, 1, biquad_form::transposed_form_2> single(c);
+        std::vector<sample> in(frames), y(frames);
+        for(size_t f = 0; f < frames; f++) in[f] = interleaved[f * channels + ch];
+        single.process(in, y);
+        for(size_t f = 0; f < frames; f++) passed &= y[f] == out[f * channels + ch];
+    }
+    return passed;
+}
+
+bool test_iir_saturation(){
+    using sample = fixed<int16_t, 8>;
+    //gain of 4 on a signal near full scale
+    std::array c{biquad_coefficients<int16_t, 12>{fp_from_bits<int16_t, 12>(4 << 12), {}, {}, {}, {}}};
+    biquad_cascade<int16_t, 8, 12, 1, 2> gain(c);
+    std::array<sample, 4> in{sample(100), sample(-100), sample(3), sample(-3)};
+    std::array<sample, 4> out;
+    gain.process(in, out);
+    return out[0].v == std::numeric_limits<int16_t>::max() and out[1].v == std::numeric_limits<int16_t>::min()
+       and out[2] == sample(12) and out[3] == sample(-12);
+}
+
+bool test_iir_noise_shaping(){
+    //a small dc step through a narrow lowpass, the plain version gets stuck on a limit cycle / dc offset
+    using sample = fixed<int16_t, 8>;
+    constexpr size_t n = 2000;
+    std::vector<double> xd(n, 0.3);
+    std::vector<sample> x(n, fp_from_bits<int16_t, 8>(static_cast<int16_t>(0.3 * 256 + 0.5)));
+    for(auto& d : xd) d = x[0].v / 256.0;
+    auto ref = reference_lowpass(xd);
+    
+    std::array c{lowpass_coefficients<int16_t, 14>()};
+    biquad_cascade<int16_t, 8, 14, 1, 1> plain(c);
+    biquad_cascade<int16_t, 8, 14, 1, 1, biquad_form::direct_form_1, noise_shaping::second_order> shaped(c);
+    std::vector<sample> y_plain(n), y_shaped(n);
+    plain.process(x, y_plain);
+    shaped.process(x, y_shaped);
+    
+    //compare the mean error over the settled second half
+    double err_plain = 0, err_shaped = 0;
+    for(size_t i = n / 2; i < n; i++){
+        err_plain += y_plain[i].v / 256.0 - ref[i];
+        err_shaped += y_shaped[i].v / 256.0 - ref[i];
+    }
+    err_plain = std::abs(err_plain / (n / 2));
+    err_shaped = std::abs(err_shaped / (n / 2));
+    return err_shaped < err_plain;
+}
+
+bool test_iir(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_iir_forms();
+    if(!passed) log_msg("failed iir forms test!");
+    all_passed &= passed;
+    
+    passed = test_iir_channels();
+    if(!passed) log_msg("failed iir channels test!");
+    all_passed &= passed;
+    
+    passed = test_iir_saturation();
+    if(!passed) log_msg("failed iir saturation test!");
+    all_passed &= passed;
+    
+    passed = test_iir_noise_shaping();
+    if(!passed) log_msg("failed iir noise shaping test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "test_interpolation.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_interpolation.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> test_image(size_t width, size_t height, uint64_t seed){
+    std::vector<fixed<T, fraction>> result(width * height);
+    for(auto& x : result){
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        x.v = static_cast<T>(seed >> 40);
+    }
+    return result;
+}
+
+//one output pixel at a time straight from the weight tables, horizontal then vertical like resample
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> reference_resample(const std::vector<fixed<T, fraction>>& src, size_t width, size_t height,
+                                                   size_t dst_width, size_t dst_height, resample_filter filter){
+    auto h = make_resample_weights(width, dst_width, filter);
+    auto v = make_resample_weights(height, dst_height, filter);
+    std::vector<fixed<T, fraction>> tmp(dst_width * height);
+    for(size_t y = 0; y < height; y++){
+        for(size_t x = 0; x < dst_width; x++){
+            int64_t acc = 0;
+            for(size_t k = 0; k < h.taps; k++) acc += int64_t{h.weights[x * h.taps + k]} * src[y * width + h.first[x] + k].v;
+            tmp[y * dst_width + x].v = saturate<T>((acc + (1 << 13)) >> 14);
+        }
+    }
+    std::vector<fixed<T, fraction>> result(dst_width * dst_height);
+    for(size_t y = 0; y < dst_height; y++){
+        for(size_t x = 0; x < dst_width; x++){
+            int64_t acc = 0;
+            for(size_t k = 0; k < v.taps; k++) acc += int64_t{v.weights[y * v.taps + k]} * tmp[(v.first[y] + k) * dst_width + x].v;
+            result[y * dst_width + x].v = saturate<T>((acc + (1 << 13)) >> 14);
+        }
+    }
+    return result;
+}
+
+template<typename T, size_t fraction>
+bool test_resample_impl(size_t width, size_t height, size_t dst_width, size_t dst_height, resample_filter filter){
+    auto src = test_image<T, fraction>(width, height, width * 31 + dst_height);
+    std::vector<fixed<T, fraction>> one(dst_width * dst_height);
+    std::vector<fixed<T, fraction>> three(dst_width * dst_height);
+    resample(std::span<const fixed<T, fraction>>(src), width, height, std::span(one), dst_width, dst_height, filter);
+    resample(std::span<const fixed<T, fraction>>(src), width, height, std::span(three), dst_width, dst_height, filter, 3);
+    return one == reference_resample(src, width, height, dst_width, dst_height, filter) and one == three;
+}
+
+bool test_interpolation(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    {
+        using pixel = fixed<uint8_t, 8>;
+        using weight = fixed<uint16_t, 8>;
+        auto a = fp_from_bits<uint8_t, 8>(200);
+        auto b = fp_from_bits<uint8_t, 8>(40);
+        passed &= lerp(a, b, fp_from_bits<uint16_t, 8>(0)) == a;
+        passed &= lerp(a, b, fp_from_bits<uint16_t, 8>(256)) == b;
+        passed &= lerp(a, b, fp_from_bits<uint16_t, 8>(128)) == fp_from_bits<uint8_t, 8>(120);
+        //rounding down stays between the end points
+        pixel previous = a;
+        bool monotonic = true;
+        for(uint16_t t = 0; t <= 256; t++){
+            pixel x = lerp(a, b, weight(fp_from_bits<uint16_t, 8>(t)));
+            monotonic &= x <= previous and x >= b;
+            previous = x;
+        }
+        passed &= monotonic;
+        
+        auto c = make_fixed<int32_t, 16>(-3);
+        auto d = make_fixed<int32_t, 16>(5);
+        passed &= lerp(c, d, fixed<int32_t, 16>(0.25_fixp_t)) == make_fixed<int32_t, 16>(-1);
+        
+        //full range 32 bit values with a 32 bit weight, the product needs 65 bits
+        auto lowest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min());
+        auto highest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::max());
+        auto almost_one = fp_from_bits<uint32_t, 32>(0xffffffffu);
+        passed &= lerp(lowest, highest, almost_one).v == std::numeric_limits<int32_t>::max() - 1;
+        passed &= lerp(highest, lowest, almost_one).v == std::numeric_limits<int32_t>::min();
+        passed &= lerp(lowest, highest, fp_from_bits<uint32_t, 32>(0x80000000u)).v == -1;
+        passed &= lerp(fp_from_bits<uint32_t, 0>(0), fp_from_bits<uint32_t, 0>(0xffffffffu), almost_one).v == 0xfffffffeu;
+    }
+    if(!passed) log_msg("failed lerp test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        auto edge0 = fp_from_bits<uint16_t, 12>(1000);
+        auto edge1 = fp_from_bits<uint16_t, 12>(5096);
+        passed &= smoothstep(edge0, edge1, fp_from_bits<uint16_t, 12>(10)).v == 0;
+        passed &= smoothstep(edge0, edge1, fp_from_bits<uint16_t, 12>(6000)).v == 4096;
+        passed &= smoothstep(edge0, edge1, fp_from_bits<uint16_t, 12>(3048)).v == 2048;
+        uint16_t previous = 0;
+        bool monotonic = true;
+        bool symmetric = true;
+        for(uint16_t x = 1000; x <= 5096; x++){
+            auto s = smoothstep(edge0, edge1, fp_from_bits<uint16_t, 12>(x));
+            auto mirrored = smoothstep(edge0, edge1, fp_from_bits<uint16_t, 12>(static_cast<uint16_t>(6096 - x)));
+            monotonic &= s.v >= previous;
+            symmetric &= std::abs(s.v + mirrored.v - 4096) <= 2;
+            previous = s.v;
+        }
+        passed &= monotonic and symmetric;
+        
+        auto s = smoothstep(fixed<int32_t, 16>(0), fixed<int32_t, 16>(2), fixed<int32_t, 16>(0.5_fixp_t));
+        passed &= std::abs(static_cast<double>(s.v) / 65536.0 - 0.15625) < 1e-4;
+        if(!passed) log_msg("failed smoothstep test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        for(auto filter : {resample_filter::bilinear, resample_filter::bicubic}){
+            for(auto [from, to] : {std::pair<size_t, size_t>{10, 25}, {25, 10}, {7, 7}, {3, 8}, {1, 4}}){
+                auto w = make_resample_weights(from, to, filter);
+                for(size_t i = 0; i < w.size(); i++){
+                    int sum = 0;
+                    for(size_t k = 0; k < w.taps; k++) sum += w.weights[i * w.taps + k];
+                    passed &= sum == 1 << 14 and w.first[i] + w.taps <= from;
+                }
+            }
+            //same size is an exact copy
+            auto image = test_image<uint16_t, 12>(9, 5, 1);
+            std::vector<fixed<uint16_t, 12>> copy(image.size());
+            resample(std::span<const fixed<uint16_t, 12>>(image), 9, 5, std::span(copy), 9, 5, filter);
+            passed &= copy == image;
+            
+            //constant images stay constant
+            std::vector<fixed<uint8_t, 8>> flat(12 * 7, fp_from_bits<uint8_t, 8>(77));
+            std::vector<fixed<uint8_t, 8>> scaled(30 * 4);
+            resample(std::span<const fixed<uint8_t, 8>>(flat), 12, 7, std::span(scaled), 30, 4, filter);
+            passed &= std::all_of(scaled.begin(), scaled.end(), [](auto x){ return x.v == 77; });
+        }
+        passed &= test_resample_impl<uint16_t, 12>(37, 23, 64, 50, resample_filter::bilinear);
+        passed &= test_resample_impl<uint16_t, 16>(64, 48, 21, 17, resample_filter::bicubic);
+        passed &= test_resample_impl<uint8_t, 8>(33, 33, 65, 65, resample_filter::bicubic);
+        passed &= test_resample_impl<int16_t, 8>(20, 30, 40, 15, resample_filter::bicubic);
+        passed &= test_resample_impl<uint8_t, 8>(2, 3, 5, 1, resample_filter::bicubic);
+        
+        //doubling a ramp with bilinear weights interpolates it
+        std::vector<fixed<uint16_t, 8>> ramp(8);
+        for(size_t i = 0; i < ramp.size(); i++) ramp[i].v = static_cast<uint16_t>(1000 * i);
+        std::vector<fixed<uint16_t, 8>> doubled(16);
+        resample(std::span<const fixed<uint16_t, 8>>(ramp), 8, 1, std::span(doubled), 16, 1, resample_filter::bilinear);
+        passed &= doubled[0].v == 0 and doubled[1].v == 250 and doubled[2].v == 750 and doubled[15].v == 7000;
+        if(!passed) log_msg("failed resample test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
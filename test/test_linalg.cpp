@@ -0,0 +1,216 @@
+#include <cstdint>
+#include <limits>
+
+#include "test_linalg.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_linalg.hpp"
+
+using namespace fixed_point;
+
+using fixp = fixed<int32_t, 16>;
+using vec2 = fixed_vec<int32_t, 16, 2>;
+using vec3 = fixed_vec<int32_t, 16, 3>;
+using mat3 = fixed_mat<int32_t, 16, 3, 3>;
+
+bool test_linalg_vector(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        vec3 a{{1.5_fixp_t, -2.0_fixp_t, 0.25_fixp_t}};
+        vec3 b{{2.0_fixp_t, 0.5_fixp_t, 4.0_fixp_t}};
+        passed &= dot(a, b) == fixp(3.0_fixp_t);
+        passed &= length_squared(b) == fixp(20.25_fixp_t);
+        passed &= length(b) == fixp(4.5_fixp_t);
+        passed &= (a + b) == vec3{{3.5_fixp_t, -1.5_fixp_t, 4.25_fixp_t}};
+        passed &= (a - b) == vec3{{-0.5_fixp_t, -2.5_fixp_t, -3.75_fixp_t}};
+        passed &= (a * fixp(2)) == vec3{{3.0_fixp_t, -4.0_fixp_t, 0.5_fixp_t}};
+        if(!passed) log_msg("failed 'vector arithmetic' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        vec3 x{{1, 0, 0}};
+        vec3 y{{0, 1, 0}};
+        passed &= cross(x, y) == vec3{{0, 0, 1}};
+        passed &= cross(y, x) == vec3{{0, 0, -1}};
+        vec2 a{{2, 0}};
+        vec2 b{{0, 3}};
+        passed &= cross(a, b) == fixp(6);
+        if(!passed) log_msg("failed 'cross product' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        vec3 a{{3, 0, 4}};
+        passed &= normalize(a) == vec3{{0.6_fixp_t, 0, 0.8_fixp_t}};
+        vec3 b{{fp_from_bits<int32_t, 16>(-192), fp_from_bits<int32_t, 16>(256), 0}};
+        auto nb = normalize(b);
+        passed &= same_up_to_one_bit(nb[0], fixp(-0.6_fixp_t));
+        passed &= same_up_to_one_bit(nb[1], fixp(0.8_fixp_t));
+        vec3 c{{100, 200, -200}};
+        auto nc = normalize(c);
+        passed &= same_up_to_one_bit(nc[0], fixp(0.333333_fixp_t));
+        passed &= same_up_to_one_bit(nc[2], fixp(-0.666667_fixp_t));
+        passed &= same_up_to_one_bit(length(nc), fixp(1));
+        vec3 zero{{0, 0, 0}};
+        passed &= normalize(zero) == zero;
+        if(!passed) log_msg("failed 'normalize' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //sums of products of full scale 32 bit components need more than 64 bits
+        const fixp highest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::max());
+        const fixp lowest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min());
+        vec3 full{{highest, highest, highest}};
+        vec3 negative{{lowest, lowest, lowest}};
+        passed &= dot(full, full) == highest and dot(full, negative) == lowest;
+        passed &= length(full) == highest and length(negative) == highest;
+        auto n = normalize(full);
+        for(size_t i = 0; i < 3; i++) passed &= same_up_to_one_bit(n[i], fixp(0.57735_fixp_t));
+        auto m = normalize(negative);
+        for(size_t i = 0; i < 3; i++) passed &= same_up_to_one_bit(m[i], fixp(-0.57735_fixp_t));
+        
+        //the partial sums overflow 64 bits but the result fits
+        using wide_vec = fixed_vec<int32_t, 30, 4>;
+        const auto big = fp_from_bits<int32_t, 30>(std::numeric_limits<int32_t>::max());
+        const auto minus_big = fp_from_bits<int32_t, 30>(-std::numeric_limits<int32_t>::max());
+        wide_vec u{{big, big, minus_big, minus_big}};
+        wide_vec v{{big, big, big, big}};
+        passed &= dot(u, v).v == 0;
+        //the difference of two products may still not fit, it saturates like dot
+        passed &= cross(vec2{{highest, highest}}, vec2{{-highest, highest}}) == highest;
+        passed &= cross(vec2{{highest, highest}}, vec2{{highest, -highest}}) == lowest;
+        if(!passed) log_msg("failed 'full scale vector' test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_linalg_matrix(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        mat3 rot{{vec3{{0, -1, 0}}, vec3{{1, 0, 0}}, vec3{{0, 0, 1}}}};
+        vec3 x{{1.5_fixp_t, 0, 2}};
+        passed &= rot * x == vec3{{0, 1.5_fixp_t, 2}};
+        passed &= rot * mat3::identity() == rot;
+        passed &= transpose(rot) * rot == mat3::identity();
+        if(!passed) log_msg("failed 'matrix product' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        fixed_mat<int32_t, 16, 2, 3> a{{fixed_vec<int32_t, 16, 3>{{1, 2, 3}}, fixed_vec<int32_t, 16, 3>{{4, 5, 6}}}};
+        auto p = a * transpose(a);
+        passed &= p[0] == vec2{{14, 32}};
+        passed &= p[1] == vec2{{32, 77}};
+        if(!passed) log_msg("failed 'matrix product' test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_linalg_batch(){
+    constexpr size_t count = 37;
+    fixed_vec_batch<int32_t, 16, 3> a(count);
+    fixed_vec_batch<int32_t, 16, 3> b(count);
+    for(size_t i = 0; i < count; i++){
+        int k = static_cast<int>(i);
+        a.set(i, vec3{{fixp(k - 18), fixp(k % 7) * 0.5_fixp_t, fixp(3)}});
+        b.set(i, vec3{{fixp(2), fixp(-k) * 0.25_fixp_t, fixp(k % 5)}});
+    }
+    
+    std::vector<fixp> dots(count);
+    std::vector<fixp> lengths(count);
+    fixed_vec_batch<int32_t, 16, 3> crosses(count);
+    fixed_vec_batch<int32_t, 16, 3> normals(count);
+    fixed_vec_batch<int32_t, 16, 3> transformed(count);
+    mat3 m{{vec3{{0.5_fixp_t, -1, 0}}, vec3{{1, 0, 2}}, vec3{{0, 0.25_fixp_t, 1}}}};
+    
+    batch_dot(a, b, std::span(dots));
+    batch_length(a, std::span(lengths));
+    batch_cross(a, b, crosses);
+    batch_normalize(a, normals);
+    batch_transform(m, a, transformed);
+    
+    bool passed = true;
+    for(size_t i = 0; i < count; i++){
+        passed &= dots[i] == dot(a.get(i), b.get(i));
+        passed &= lengths[i] == length(a.get(i));
+        passed &= crosses.get(i) == cross(a.get(i), b.get(i));
+        passed &= normals.get(i) == normalize(a.get(i));
+        passed &= transformed.get(i) == m * a.get(i);
+    }
+    if(!passed) log_msg("failed 'batch kernels' test!");
+    
+    //the split 64 bit sums of the batch kernels give the same results as the 128 bit sums of the scalar functions
+    auto full_scale = [&]<size_t fraction>(){
+        using vec = fixed_vec<int32_t, fraction, 3>;
+        using batch = fixed_vec_batch<int32_t, fraction, 3>;
+        const auto hi = fp_from_bits<int32_t, fraction>(std::numeric_limits<int32_t>::max());
+        const auto lo = fp_from_bits<int32_t, fraction>(std::numeric_limits<int32_t>::min());
+        const auto one = fp_from_bits<int32_t, fraction>(1);
+        const auto zero = fp_from_bits<int32_t, fraction>(0);
+        std::array<vec, 6> vectors = {vec{{hi, hi, hi}}, vec{{lo, lo, lo}}, vec{{hi, lo, one}},
+                                      vec{{lo, hi, zero}}, vec{{one, -one, hi}}, vec{{zero, zero, one}}};
+        const size_t n = vectors.size() * vectors.size();
+        batch x(n), y(n), crossed(n), mapped(n);
+        for(size_t i = 0; i < n; i++){
+            x.set(i, vectors[i / vectors.size()]);
+            y.set(i, vectors[i % vectors.size()]);
+        }
+        std::vector<fixed<int32_t, fraction>> d(n), l(n);
+        fixed_mat<int32_t, fraction, 3, 3> mat{{vectors[0], vectors[1], vectors[2]}};
+        batch_dot(x, y, std::span(d));
+        batch_length(x, std::span(l));
+        batch_cross(x, y, crossed);
+        batch_transform(mat, x, mapped);
+        bool ok = true;
+        for(size_t i = 0; i < n; i++){
+            ok &= d[i] == dot(x.get(i), y.get(i));
+            ok &= l[i] == length(x.get(i));
+            ok &= crossed.get(i) == cross(x.get(i), y.get(i));
+            ok &= mapped.get(i) == vec{{dot(mat[0], x.get(i)), dot(mat[1], x.get(i)), dot(mat[2], x.get(i))}};
+        }
+        fixed_mat<int32_t, fraction, 3, 3> squared = mat * mat;
+        for(size_t r = 0; r < 3; r++){
+            for(size_t c = 0; c < 3; c++) ok &= squared[r][c] == dot(mat[r], transpose(mat)[c]);
+        }
+        return ok;
+    };
+    bool full_passed = full_scale.template operator()<0>();
+    full_passed &= full_scale.template operator()<16>();
+    full_passed &= full_scale.template operator()<31>();
+    if(!full_passed) log_msg("failed 'full scale batch kernels' test!");
+    return passed and full_passed;
+}
+
+bool test_linalg(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_linalg_vector();
+    if(!passed) log_msg("failed linalg vector test!");
+    all_passed &= passed;
+    
+    passed = test_linalg_matrix();
+    if(!passed) log_msg("failed linalg matrix test!");
+    all_passed &= passed;
+    
+    passed = test_linalg_batch();
+    if(!passed) log_msg("failed linalg batch test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <vector>
+
+#include "test_packed.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_packed.hpp"
+
+using namespace fixed_point;
+
+template<size_t bits, size_t fraction, bool is_signed, typename T>
+bool test_packed_round_trip(size_t count, size_t first, size_t length){
+    using array_t = packed_fixed_array<bits, fraction, is_signed>;
+    array_t packed(count);
+    std::vector<int64_t> expected(count);
+    
+    bool passed = true;
+    uint32_t seed = 12345;
+    for(size_t i = 0; i < count; i++){
+        seed = seed * 1664525u + 1013904223u;
+        int64_t span = array_t::max_bits - array_t::min_bits + 1;
+        expected[i] = array_t::min_bits + static_cast<int64_t>(seed % static_cast<uint64_t>(span));
+        packed.set(i, fp_from_bits<T, fraction>(static_cast<T>(expected[i])));
+    }
+    for(size_t i = 0; i < count; i++) passed &= packed[i].v == expected[i];
+    
+    //bulk unpack from an unaligned start, then pack back shifted by one
+    std::vector<fixed<T, fraction>> unpacked(length);
+    packed.template unpack<T>(first, unpacked);
+    for(size_t j = 0; j < length; j++) passed &= unpacked[j].v == expected[first + j];
+    
+    packed.template pack<T>(first + 1, std::span<const fixed<T, fraction>>(unpacked).first(length - 1));
+    for(size_t i = 0; i < count; i++){
+        int64_t want = i > first and i < first + length ? expected[i - 1] : expected[i];
+        passed &= packed[i].v == want;
+    }
+    return passed;
+}
+
+bool test_packed(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    passed &= test_packed_round_trip<10, 8, true, int16_t>(1000, 3, 700);
+    passed &= test_packed_round_trip<12, 4, true, int16_t>(999, 0, 999);
+    passed &= test_packed_round_trip<12, 12, false, uint16_t>(77, 5, 60);
+    passed &= test_packed_round_trip<24, 16, true, int32_t>(513, 7, 500);
+    passed &= test_packed_round_trip<1, 0, false, int16_t>(100, 1, 90);
+    passed &= test_packed_round_trip<32, 16, true, int32_t>(40, 2, 30);
+    if(!passed) log_msg("failed packed round trip test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        packed_fixed_array<10, 4> a(5);
+        //10 bits with 4 fractional bits hold [-32, 32), out of range values saturate
+        a.set(0, fixed<int16_t, 4>(100));
+        a.set(1, fixed<int16_t, 4>(-100));
+        a.set(2, fixed<int16_t, 4>(3));
+        passed &= a[0].v == 511 and a[1].v == -512 and a[2] == fixed<int16_t, 4>(3);
+        passed &= a.byte_size() == 7;
+        a.resize(2);
+        a.resize(5);
+        passed &= a[0].v == 511 and a[1].v == -512 and a[2].v == 0;
+        if(!passed) log_msg("failed packed saturation test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //shrinking clears everything behind the last element, a full group and the padding included
+        packed_fixed_array<8, 0, false> a(40);
+        packed_fixed_array<5, 0, false> b(40);
+        for(size_t i = 0; i < 40; i++){
+            a.set(i, fixed<uint8_t, 0>(static_cast<uint8_t>(i + 1)));
+            b.set(i, fixed<uint8_t, 0>(static_cast<uint8_t>(i % 31 + 1)));
+        }
+        a.resize(3);
+        a.resize(40);
+        b.resize(3);
+        b.resize(40);
+        for(size_t i = 0; i < 3; i++) passed &= a[i].v == i + 1 and b[i].v == i + 1;
+        for(size_t i = 3; i < 40; i++) passed &= a[i].v == 0 and b[i].v == 0;
+        b.resize(0);
+        b.resize(16);
+        for(size_t i = 0; i < 16; i++) passed &= b[i].v == 0;
+        if(!passed) log_msg("failed packed resize test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_parallel.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_parallel.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> parallel_values(size_t n, uint64_t seed, int shift){
+    std::vector<fixed<T, fraction>> result(n);
+    for(auto& x : result){
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        x.v = static_cast<T>(static_cast<int64_t>(seed) >> shift);
+    }
+    return result;
+}
+
+bool test_parallel(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    {
+        auto values = parallel_values<int32_t, 16>(100003, 1, 33);
+        std::span<const fixed<int32_t, 16>> view(values);
+        int64_t expected = 0;
+        for(auto x : values) expected += x.v;
+        for(size_t threads : {1, 2, 3, 7, 16}) passed &= parallel_sum(view, threads).v == expected;
+        passed &= parallel_sum(std::span<const fixed<int32_t, 16>>()).v == 0;
+        
+        auto wide = parallel_values<int64_t, 32>(5000, 2, 0);
+        std::span<const fixed<int64_t, 32>> wide_view(wide);
+        wide_int<128> wide_expected = 0;
+        for(auto x : wide) wide_expected += wide_int<128>(x.v);
+        passed &= parallel_sum(wide_view).v == wide_expected and parallel_sum(wide_view, 5).v == wide_expected;
+    }
+    if(!passed) log_msg("failed parallel sum test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        auto a = parallel_values<int16_t, 8>(77777, 3, 48);
+        auto b = parallel_values<int16_t, 8>(77777, 4, 48);
+        std::span<const fixed<int16_t, 8>> va(a);
+        std::span<const fixed<int16_t, 8>> vb(b);
+        int64_t exact = 0;
+        for(size_t i = 0; i < a.size(); i++) exact += int64_t{a[i].v} * b[i].v;
+        auto expected = fp_from_bits<int16_t, 8>(saturate<int16_t>(rounding_shift_right(exact, 8)));
+        for(size_t threads : {1, 4, 9}) passed &= parallel_dot(va, vb, threads) == expected;
+        
+        //small values whose dot product fits
+        auto c = parallel_values<int32_t, 16>(1000, 5, 50);
+        std::span<const fixed<int32_t, 16>> vc(c);
+        int64_t squares = 0;
+        for(auto x : c) squares += int64_t{x.v} * x.v;
+        passed &= parallel_dot(vc, vc, 3).v == rounding_shift_right(squares, 16);
+        
+        //dot products whose partial sums exceed 64 bits
+        std::vector<fixed<int32_t, 30>> big(1000, fp_from_bits<int32_t, 30>(std::numeric_limits<int32_t>::max()));
+        std::vector<fixed<int32_t, 30>> sign(1000);
+        for(size_t i = 0; i < sign.size(); i++) sign[i] = i < 500 ? big[i] : fp_from_bits<int32_t, 30>(-std::numeric_limits<int32_t>::max());
+        std::span<const fixed<int32_t, 30>> big_view(big);
+        passed &= parallel_dot(big_view, std::span<const fixed<int32_t, 30>>(sign), 3).v == 0;
+        passed &= parallel_dot(big_view, big_view, 3).v == std::numeric_limits<int32_t>::max();
+        if(!passed) log_msg("failed parallel dot test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        auto values = parallel_values<int32_t, 16>(50001, 6, 32);
+        std::span<const fixed<int32_t, 16>> view(values);
+        auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+        for(size_t threads : {1, 2, 8}){
+            auto [a, b] = parallel_minmax(view, threads);
+            passed &= a == *lo and b == *hi;
+        }
+        std::vector<fixed<uint8_t, 4>> single(1, fp_from_bits<uint8_t, 4>(200));
+        auto [a, b] = parallel_minmax(std::span<const fixed<uint8_t, 4>>(single), 4);
+        passed &= a.v == 200 and b.v == 200;
+        if(!passed) log_msg("failed parallel min max test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        auto values = parallel_values<int32_t, 16>(40000, 7, 44);
+        std::span<const fixed<int32_t, 16>> view(values);
+        double squares = 0;
+        for(auto x : values) squares += static_cast<double>(x.v) * x.v;
+        auto one = parallel_norm(view);
+        passed &= std::abs(one.v - std::sqrt(squares)) <= 0.5;
+        for(size_t threads : {2, 5, 12}) passed &= parallel_norm(view, threads) == one;
+        
+        //3-4-5 triangle
+        std::vector<fixed<uint16_t, 8>> triangle = {make_fixed<uint16_t, 8>(3), make_fixed<uint16_t, 8>(4)};
+        passed &= parallel_norm(std::span<const fixed<uint16_t, 8>>(triangle)) == make_fixed<uint16_t, 8>(5);
+        
+        auto wide = parallel_values<int64_t, 32>(1000, 8, 20);
+        std::span<const fixed<int64_t, 32>> wide_view(wide);
+        passed &= parallel_norm(wide_view, 3) == parallel_norm(wide_view);
+        
+        //sums of squares beyond 64 and 128 bits saturate instead of wrapping
+        std::vector<fixed<int32_t, 30>> ones(16, make_fixed<int32_t, 30>(1));
+        passed &= parallel_norm(std::span<const fixed<int32_t, 30>>(ones), 4).v == std::numeric_limits<int32_t>::max();
+        std::vector<fixed<int32_t, 16>> large(5, fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::max()));
+        passed &= parallel_norm(std::span<const fixed<int32_t, 16>>(large)).v == std::numeric_limits<int32_t>::max();
+        std::vector<fixed<int64_t, 32>> wide_large(16, fp_from_bits<int64_t, 32>(int64_t{1} << 62));
+        passed &= parallel_norm(std::span<const fixed<int64_t, 32>>(wide_large)).v == std::numeric_limits<int64_t>::max();
+        std::vector<fixed<int32_t, 30>> halves(3, fp_from_bits<int32_t, 30>(1 << 29));
+        passed &= parallel_norm(std::span<const fixed<int32_t, 30>>(halves)).v == static_cast<int32_t>(std::lround(std::sqrt(0.75) * (1 << 30)));
+        if(!passed) log_msg("failed parallel norm test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_polynomial.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_polynomial.hpp"
+
+using namespace fixed_point;
+
+namespace{
+
+using fixed_t = fixed<int32_t, 16>;
+
+double to_double(fixed_t x){
+    return static_cast<double>(x.v) / 65536.0;
+}
+
+fixed_t from_double(double x){
+    return fp_from_bits<int32_t, 16>(static_cast<int32_t>(std::lround(x * 65536.0)));
+}
+
+constexpr auto reciprocal_fit = fit_polynomial<6>([](double x){ return 1.0 / (1.0 + x); }, 0.0, 1.0);
+constexpr auto cubic_fit = fit_polynomial<3>([](double x){ return x * x * x - 2.0 * x + 0.5; }, -2.0, 3.0);
+
+}
+
+bool test_polynomial(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    {
+        using p = fixed_polynomial<fixed_t, 1.0_fixp_t, -0.5_fixp_t, 0.125_fixp_t, -0.0078125_fixp_t>;
+        static_assert(p::degree == 3);
+        static_assert(p::q32_coefficients[1] == -(int64_t{1} << 31));
+        static_assert(p::horner(make_fixed<int32_t, 16>(0)) == make_fixed<int32_t, 16>(1));
+        double worst_horner = 0;
+        double worst_estrin = 0;
+        for(int i = -2000; i <= 2000; i++){
+            fixed_t x = fp_from_bits<int32_t, 16>(i * 97);
+            double u = to_double(x);
+            double expected = 1.0 - 0.5 * u + 0.125 * u * u - 0.0078125 * u * u * u;
+            worst_horner = std::max(worst_horner, std::abs(to_double(p::horner(x)) - expected));
+            worst_estrin = std::max(worst_estrin, std::abs(to_double(p::estrin(x)) - expected));
+        }
+        //only the final rounding is visible
+        passed &= worst_horner <= 0.6 / 65536.0 and worst_estrin <= 0.6 / 65536.0;
+        
+        //mixed coefficient types
+        using q = fixed_polynomial<fixed<int16_t, 8>, 0.25, make_fixed<int16_t, 8>(2), -1.5_fixp_t>;
+        passed &= q{}(make_fixed<int16_t, 8>(2)) == fixed<int16_t, 8>(-1.75_fixp_t);
+        passed &= q::estrin(make_fixed<int16_t, 8>(2)) == fixed<int16_t, 8>(-1.75_fixp_t);
+        
+        std::vector<fixed_t> in(100);
+        std::vector<fixed_t> out(100);
+        for(size_t i = 0; i < in.size(); i++) in[i] = fp_from_bits<int32_t, 16>(static_cast<int32_t>(i * 4099) - 200000);
+        p::evaluate(std::span<const fixed_t>(in), std::span(out));
+        for(size_t i = 0; i < in.size(); i++) passed &= out[i] == p::horner(in[i]);
+    }
+    if(!passed) log_msg("failed polynomial evaluation test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //intermediates beyond the int64 range saturate instead of wrapping
+        using fixed_t = fixed<int32_t, 16>;
+        using cube = fixed_polynomial<fixed_t, 0.0, 0.0, 0.0, 1.0>;
+        const fixed_t highest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::max());
+        const fixed_t lowest = fp_from_bits<int32_t, 16>(std::numeric_limits<int32_t>::min());
+        for(int i : {40, 1000, 2000, 3000, 32767}){
+            passed &= cube::horner(make_fixed<int32_t, 16>(i)) == highest and cube::estrin(make_fixed<int32_t, 16>(i)) == highest;
+            passed &= cube::horner(make_fixed<int32_t, 16>(-i)) == lowest and cube::estrin(make_fixed<int32_t, 16>(-i)) == lowest;
+        }
+        passed &= cube::horner(make_fixed<int32_t, 16>(20)) == make_fixed<int32_t, 16>(8000);
+        
+        //the full range of a format without fractional bits
+        using integer_t = fixed<int32_t, 0>;
+        using line = fixed_polynomial<integer_t, 3.0, 1.0>;
+        for(int32_t v : {std::numeric_limits<int32_t>::min() + 5, -70000, 0, 70000, std::numeric_limits<int32_t>::max() - 5}){
+            integer_t x = fp_from_bits<int32_t, 0>(v);
+            passed &= line::horner(x).v == v + 3 and line::estrin(x).v == v + 3;
+        }
+        integer_t top = fp_from_bits<int32_t, 0>(std::numeric_limits<int32_t>::max());
+        passed &= line::horner(top) == top and line::estrin(top) == top;
+    }
+    if(!passed) log_msg("failed polynomial range test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        //a cubic is reproduced by a cubic fit
+        passed &= std::abs(cubic_fit[0] - 0.5) < 1e-9 and std::abs(cubic_fit[1] + 2.0) < 1e-9;
+        passed &= std::abs(cubic_fit[2]) < 1e-9 and std::abs(cubic_fit[3] - 1.0) < 1e-9;
+        
+        using p = polynomial_from_array_t<fixed_t, reciprocal_fit>;
+        static_assert(p::degree == 6);
+        double worst = 0;
+        for(int i = 0; i <= 1000; i++){
+            double x = i / 1000.0;
+            worst = std::max(worst, std::abs(to_double(p::horner(from_double(x))) - 1.0 / (1.0 + x)));
+        }
+        passed &= worst < 3e-5;
+        if(!passed) log_msg("failed polynomial fit test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //a straight line is reproduced exactly by a natural spline
+        std::vector<fixed_t> xs = {from_double(-1.0), from_double(0.5), from_double(0.75), from_double(2.0), from_double(4.0)};
+        std::vector<fixed_t> ys;
+        for(auto x : xs) ys.push_back(from_double(2.0 * to_double(x) + 1.0));
+        cubic_spline<int32_t, 16> line(xs, ys);
+        passed &= not line.uniform_knots() and line.segment_count() == 4;
+        for(int i = -1000; i <= 4000; i += 7){
+            fixed_t x = from_double(i / 1000.0);
+            passed &= std::abs(line(x).v - from_double(2.0 * to_double(x) + 1.0).v) <= 1;
+        }
+        passed &= line(from_double(-5.0)) == ys.front() and line(from_double(9.0)) == ys.back();
+        
+        //the spline of a smooth function passes through the knots and stays close in between
+        std::vector<fixed_t> uniform_xs;
+        std::vector<fixed_t> uniform_ys;
+        for(int i = 0; i <= 16; i++){
+            uniform_xs.push_back(from_double(i * 0.25));
+            uniform_ys.push_back(from_double(std::sin(i * 0.25)));
+        }
+        cubic_spline<int32_t, 16> curve(uniform_xs, uniform_ys);
+        passed &= curve.uniform_knots();
+        for(size_t i = 0; i < uniform_xs.size(); i++) passed &= std::abs(curve(uniform_xs[i]).v - uniform_ys[i].v) <= 1;
+        //the natural end conditions do not match sin, so the error is larger towards the ends
+        double worst_inside = 0;
+        double worst = 0;
+        for(int i = 0; i <= 4000; i++){
+            double x = i / 1000.0;
+            double error = std::abs(to_double(curve(from_double(x))) - std::sin(x));
+            if(x >= 1.0 and x <= 3.0) worst_inside = std::max(worst_inside, error);
+            worst = std::max(worst, error);
+        }
+        passed &= worst_inside < 5e-5 and worst < 5e-3;
+        
+        //the division lookup for equal spacing finds the same segments as the binary search
+        for(int i = 0; i <= 4000; i += 3){
+            fixed_t x = from_double(i / 1000.0);
+            size_t expected = std::min<size_t>(upper_bound(std::span<const fixed_t>(uniform_xs), x) - 1, 15);
+            passed &= curve.segment_of(x) == expected;
+        }
+        
+        std::vector<fixed_t> in;
+        for(int i = -200; i < 4500; i += 13) in.push_back(from_double(i / 1000.0));
+        std::vector<fixed_t> out(in.size());
+        curve.evaluate(std::span<const fixed_t>(in), std::span(out));
+        for(size_t i = 0; i < in.size(); i++) passed &= out[i] == curve(in[i]);
+        
+        //knots one lsb apart with full scale jumps need coefficients far beyond 2^31, they saturate instead of overflowing
+        std::vector<fixed_t> steep_xs, steep_ys;
+        for(int32_t i = 0; i < 4; i++){
+            steep_xs.push_back(fp_from_bits<int32_t, 16>(i));
+            steep_ys.push_back(fp_from_bits<int32_t, 16>(i % 2 == 0 ? -2000000000 : 2000000000));
+        }
+        cubic_spline<int32_t, 16> steep(steep_xs, steep_ys);
+        for(size_t i = 0; i + 1 < steep_xs.size(); i++) passed &= steep(steep_xs[i]) == steep_ys[i];
+        if(!passed) log_msg("failed cubic spline test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
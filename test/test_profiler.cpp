@@ -0,0 +1,140 @@
+#include "test_profiler.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_profiler.hpp"
+
+using namespace fixed_point;
+
+bool test_profiler_range(){
+    using fixp = profiling_fixed<int32_t, 16>;
+    range_profiler profiler;
+    
+    fixp acc("acc", 0, profiler);
+    fixp x("x", profiler);
+    for(int i = -10; i <= 10; i++){
+        x = fixp(i) * 0.25_fixp_t;
+        acc += x * x;
+    }
+    
+    const auto& vars = profiler.variables();
+    bool passed = true;
+    passed &= vars.at("x").min == -2.5;
+    passed &= vars.at("x").max == 2.5;
+    passed &= vars.at("x").samples == 21;
+    passed &= vars.at("acc").min == 0.0;
+    passed &= vars.at("acc").max == 48.125;
+    
+    //x only ever holds multiples of 0.25, 2 fractional bits are enough for it
+    passed &= vars.at("x").smallest_magnitude == 0.25;
+    auto rec = recommend(vars.at("x"));
+    passed &= rec.int_bits == 8 and rec.is_signed and rec.fraction == 5;
+    
+    //an explicitly requested resolution wins over the observed one
+    fixp y;
+    y.track("y", 1.0 / 4096, profiler);
+    fixp z;
+    z.track("z", profiler);
+    for(int i = 0; i < 100; i++){
+        y = fixp(i) * 0.5_fixp_t;
+        z = fixp(i) * 0.001_fixp_t;
+    }
+    passed &= recommend(vars.at("y")).int_bits == 32 and recommend(vars.at("y")).fraction == 26;
+    //z needs 10 fractional bits for 0.001 and 0 whole bits, 16 bits unsigned leave 16 for the fraction
+    auto z_rec = recommend(vars.at("z"));
+    passed &= z_rec.int_bits == 16 and not z_rec.is_signed and z_rec.fraction == 16;
+    
+    //large values with small steps keep every fractional bit of the profiled Q16 type, not just what their magnitude suggests
+    fixp w;
+    w.track("w", profiler);
+    for(int i = 0; i <= 100; i++) w = fixp(100) + fixp(i) * 0.001_fixp_t;
+    passed &= vars.at("w").finest_fraction == 16;
+    auto w_rec = recommend(vars.at("w"));
+    passed &= w_rec.int_bits == 32 and not w_rec.is_signed and w_rec.fraction == 25;
+    
+    //the string of a 64 bit variable is as long as the one of the fixed it profiles
+    const auto big = fp_from_bits<int64_t, 32>(-(int64_t{123456789012} << 32) - (int64_t{1} << 31));
+    passed &= profiling_fixed<int64_t, 32>(big).to_string() == big.to_string();
+    return passed;
+}
+
+bool test_profiler_recommendation(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        range_record r;
+        r.resolution = 1.0/256;
+        r.record(-2.5);
+        r.record(2.5);
+        auto rec = recommend(r);
+        //1 sign bit + 2 whole bits + 8 fractional bits fit into 16 bits, the rest goes to the fraction
+        passed &= rec.fits;
+        passed &= rec.int_bits == 16;
+        passed &= rec.is_signed;
+        passed &= rec.fraction == 13;
+        if(!passed) log_msg("failed 'profiler recommendation' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        range_record r;
+        r.resolution = 1.0/16;
+        r.record(0.0);
+        r.record(12.0);
+        auto rec = recommend(r);
+        passed &= rec.fits;
+        passed &= rec.int_bits == 8;
+        passed &= !rec.is_signed;
+        passed &= rec.fraction == 4;
+        if(!passed) log_msg("failed 'profiler recommendation' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        range_record r;
+        r.resolution = 1.0/65536;
+        r.record(-70000.0);
+        auto rec = recommend(r);
+        passed &= rec.fits;
+        passed &= rec.int_bits == 64;
+        passed &= rec.fraction == 46;
+        if(!passed) log_msg("failed 'profiler recommendation' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        //the exact binary fractions recorded decide the precision, not the smallest magnitude
+        range_record r;
+        r.record(100.5);
+        r.record(150.125);
+        r.record(199.0);
+        passed &= r.finest_fraction == 3;
+        auto rec = recommend(r);
+        passed &= rec.fits;
+        passed &= rec.int_bits == 16;
+        passed &= rec.fraction == 8;
+        passed &= fractional_bits_needed(0.25) == 2 and fractional_bits_needed(3.0) == 0 and fractional_bits_needed(-0.75) == 2;
+        if(!passed) log_msg("failed 'profiler recommendation' test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_profiler(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_profiler_range();
+    if(!passed) log_msg("failed profiler range test!");
+    all_passed &= passed;
+    
+    passed = test_profiler_recommendation();
+    if(!passed) log_msg("failed profiler recommendation test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
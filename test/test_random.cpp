@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_random.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_random.hpp"
+
+using namespace fixed_point;
+
+bool test_random(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    //known answers from the philox reference implementation
+    passed &= philox4x32({0, 0, 0, 0}, {0, 0}) == std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    passed &= philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+              std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+    {
+        xoshiro256ss a(42);
+        xoshiro256ss b(42);
+        xoshiro256ss c(42);
+        c.jump();
+        bool same = true;
+        bool different = false;
+        for(int i = 0; i < 100; i++){
+            uint64_t x = a();
+            same &= x == b();
+            different |= x != c();
+        }
+        passed &= same and different;
+    }
+    if(!passed) log_msg("failed generator test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        xoshiro256ss gen(1);
+        //8 fractional bits give 256 equally likely values
+        std::vector<size_t> counts(256, 0);
+        constexpr size_t draws = 256 * 1000;
+        for(size_t i = 0; i < draws; i++){
+            auto x = uniform01<uint8_t, 8>(gen);
+            counts[x.v]++;
+        }
+        auto [lo, hi] = std::minmax_element(counts.begin(), counts.end());
+        passed &= *lo > 850 and *hi < 1150;
+        
+        for(int i = 0; i < 1000; i++){
+            auto x = uniform01<int32_t, 16>(gen);
+            passed &= x.v >= 0 and x.v < (1 << 16);
+        }
+        
+        //a range of 3 does not divide 2^64, rejection keeps the three values equally likely
+        std::array<size_t, 3> thirds{};
+        auto lo3 = fp_from_bits<int16_t, 4>(-1);
+        auto hi3 = fp_from_bits<int16_t, 4>(2);
+        for(int i = 0; i < 30000; i++){
+            auto x = uniform(gen, lo3, hi3);
+            passed &= x >= lo3 and x < hi3;
+            thirds[static_cast<size_t>(x.v + 1)]++;
+        }
+        for(size_t c : thirds) passed &= c > 9500 and c < 10500;
+        
+        //the full range of a signed type
+        auto min = fp_from_bits<int8_t, 2>(-128);
+        auto max = fp_from_bits<int8_t, 2>(127);
+        bool saw_min = false;
+        for(int i = 0; i < 10000; i++) saw_min |= uniform(gen, min, max) == min;
+        passed &= saw_min;
+        if(!passed) log_msg("failed uniform test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        xoshiro256ss gen(7);
+        constexpr size_t n = 200000;
+        double sum = 0;
+        double sum_squares = 0;
+        size_t beyond_two = 0;
+        size_t tail = 0;
+        for(size_t i = 0; i < n; i++){
+            double x = normal<int32_t, 16>(gen).v / 65536.0;
+            sum += x;
+            sum_squares += x * x;
+            beyond_two += std::abs(x) > 2.0;
+            tail += std::abs(x) > 3.442619855899;
+        }
+        double mean = sum / n;
+        double variance = sum_squares / n - mean * mean;
+        passed &= std::abs(mean) < 0.01;
+        passed &= std::abs(variance - 1.0) < 0.02;
+        //P(|x| > 2) = 0.0455, P(|x| > r) = 0.000576
+        passed &= std::abs(static_cast<double>(beyond_two) / n - 0.0455) < 0.003;
+        passed &= tail > 60 and tail < 180;
+        
+        //the layer and the value come from different bits, so a wide format gets close to 57 bits of the value
+        sum = 0;
+        sum_squares = 0;
+        uint64_t low_bits = 0;
+        for(size_t i = 0; i < n; i++){
+            int64_t v = normal<int64_t, 59>(gen).v;
+            double x = std::ldexp(static_cast<double>(v), -59);
+            sum += x;
+            sum_squares += x * x;
+            low_bits |= static_cast<uint64_t>(v) & 0xffffff;
+        }
+        mean = sum / n;
+        variance = sum_squares / n - mean * mean;
+        passed &= std::abs(mean) < 0.01 and std::abs(variance - 1.0) < 0.02;
+        passed &= low_bits == 0xffffff;
+        if(!passed) log_msg("failed normal test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        std::vector<fixed<int32_t, 16>> one(10007);
+        std::vector<fixed<int32_t, 16>> four(10007);
+        fill_normal(std::span(one), 99);
+        fill_normal(std::span(four), 99, 0, 4);
+        passed &= one == four;
+        
+        //a fill starting at an offset continues the same sequence
+        std::vector<fixed<int32_t, 16>> tail(7);
+        fill_normal(std::span(tail), 99, 10000);
+        passed &= std::equal(tail.begin(), tail.end(), one.begin() + 10000);
+        
+        std::vector<fixed<uint16_t, 16>> unit_one(5000);
+        std::vector<fixed<uint16_t, 16>> unit_three(5000);
+        fill_uniform01(std::span(unit_one), 5);
+        fill_uniform01(std::span(unit_three), 5, 0, 3);
+        passed &= unit_one == unit_three;
+        
+        std::vector<fixed<int16_t, 8>> range_one(3000);
+        std::vector<fixed<int16_t, 8>> range_two(3000);
+        auto lo = make_fixed<int16_t, 8>(-3);
+        auto hi = make_fixed<int16_t, 8>(5);
+        fill_uniform(std::span(range_one), lo, hi, 11);
+        fill_uniform(std::span(range_two), lo, hi, 11, 0, 2);
+        passed &= range_one == range_two;
+        passed &= std::all_of(range_one.begin(), range_one.end(), [&](auto x){ return x >= lo and x < hi; });
+        
+        std::vector<fixed<int32_t, 16>> other_seed(10007);
+        fill_normal(std::span(other_seed), 100);
+        passed &= one != other_seed;
+        if(!passed) log_msg("failed bulk fill test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+
+#include "test_range.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_range.hpp"
+
+using namespace fixed_point;
+
+bool test_range_storage(){
+    static_assert(std::is_same_v<ranged_fixed<0, 255, 4>::int_type, uint8_t>);
+    static_assert(std::is_same_v<ranged_fixed<-129, 0, 4>::int_type, int16_t>);
+    static_assert(std::is_same_v<ranged_fixed_whole<-4, 4, 16>::int_type, int32_t>);
+    static_assert(std::is_same_v<ranged_fixed_whole<-4, 3, 4>::int_type, int8_t>);
+    static_assert(sizeof(std::array<ranged_fixed<0, 1000, 8>, 16>) == 16 * sizeof(uint16_t));
+    return true;
+}
+
+bool test_range_arithmetic(){
+    using sample = ranged_fixed_whole<-2, 2, 6>; //[-128, 128] as bits, int16_t
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        sample a = ranged_from_bits<-128, 128, 6>(96); //1.5
+        sample b = ranged_from_bits<-128, 128, 6>(-32); //-0.5
+        auto c = a + b;
+        static_assert(decltype(c)::min_as_bits() == -256 and decltype(c)::max_as_bits() == 256);
+        passed &= c.v == 64;
+        auto d = a - b;
+        passed &= d.v == 128;
+        auto e = a * b; //exact product with 12 fractional bits
+        static_assert(decltype(e)::frac_bits() == 12);
+        static_assert(decltype(e)::min_as_bits() == -16384 and decltype(e)::max_as_bits() == 16384);
+        static_assert(std::is_same_v<decltype(e)::int_type, int16_t>);
+        passed &= e.v == -3072;
+        if(!passed) log_msg("failed 'ranged arithmetic' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using fp = fixed<int32_t, 16>;
+        auto k = ranged_constant<fp(0.25_fixp_t)>();
+        static_assert(decltype(k)::min_as_bits() == 16384 and decltype(k)::max_as_bits() == 16384);
+        sample a = ranged_from_bits<-128, 128, 6>(64); //1.0
+        auto c = a * k + a; //mixed fractions are aligned
+        static_assert(decltype(c)::frac_bits() == 22);
+        auto f = static_cast<fp>(c);
+        passed &= f == fp(1.25_fixp_t);
+        passed &= a < c;
+        passed &= c == a + a * k;
+        if(!passed) log_msg("failed 'ranged mixed fraction' test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        fixed<int32_t, 6> x = 1;
+        sample a(x);
+        auto t = truncate_to<2>(a * a);
+        static_assert(decltype(t)::max_as_bits() == 16 and decltype(t)::min_as_bits() == -16);
+        static_assert(std::is_same_v<decltype(t)::int_type, int8_t>);
+        passed &= t.v == 4;
+        static_assert(decltype(t)::fits_in<int8_t, 2>());
+        static_assert(!decltype(t)::fits_in<int8_t, 6>());
+        passed &= static_cast<fixed<int8_t, 2>>(t).v == 4;
+        if(!passed) log_msg("failed 'ranged conversion' test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_range(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_range_storage();
+    if(!passed) log_msg("failed range storage test!");
+    all_passed &= passed;
+    
+    passed = test_range_arithmetic();
+    if(!passed) log_msg("failed range arithmetic test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
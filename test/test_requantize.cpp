@@ -0,0 +1,149 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_requantize.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_requantize.hpp"
+#include "fixed_point_convert.hpp"
+
+using namespace fixed_point;
+
+using wide_sample = fixed<int32_t, 24>;
+using narrow_sample = fixed<int16_t, 15>;
+
+//sum of squared sums over blocks of 256 samples of out - in in target lsb, the error power at low frequencies
+template<typename S, typename T>
+double low_frequency_error(const std::vector<S>& in, const std::vector<T>& out){
+    double power = 0.0;
+    for(size_t start = 0; start + 256 <= in.size(); start += 256){
+        int64_t sum = 0;
+        for(size_t i = start; i < start + 256; i++) sum += (static_cast<int64_t>(out[i].v) << 9) - in[i].v;
+        double block = static_cast<double>(sum) / 512.0;
+        power += block * block;
+    }
+    return power;
+}
+
+bool test_requantize(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    std::vector<wide_sample> signal(20000);
+    for(size_t i = 0; i < signal.size(); i++){
+        signal[i].v = static_cast<int32_t>(std::lround(0.6 * std::sin(0.001 * static_cast<double>(i)) * (1 << 24)));
+    }
+    std::vector<narrow_sample> out(signal.size());
+    std::span<const wide_sample> in_view(signal);
+    
+    passed = true;
+    {
+        //without dither and feedback it is fixed_cast with rounding and saturation
+        std::vector<wide_sample> edge = {fp_from_bits<int32_t, 24>(0x7fffffff), fp_from_bits<int32_t, 24>(-0x7fffffff - 1),
+                                         fp_from_bits<int32_t, 24>(255), fp_from_bits<int32_t, 24>(256), fp_from_bits<int32_t, 24>(-257)};
+        edge.insert(edge.end(), signal.begin(), signal.begin() + 1000);
+        std::vector<narrow_sample> edge_out(edge.size());
+        requantize<narrow_sample, 0>(std::span<const wide_sample>(edge), std::span(edge_out), 1, dither_mode::none);
+        for(size_t i = 0; i < edge.size(); i++) passed &= edge_out[i].v == fixed_cast<int16_t, 15>(edge[i]).v;
+    }
+    if(!passed) log_msg("failed requantize rounding test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //the dither sequence does not depend on how the input is split
+        requantize<narrow_sample, 2>(in_view, std::span(out), 1, dither_mode::triangular, 7);
+        std::vector<narrow_sample> split(signal.size());
+        requantizer<wide_sample, narrow_sample, 2> r(1, dither_mode::triangular, 7);
+        r.process(in_view.first(333), std::span(split).first(333));
+        r.process(in_view.subspan(333), std::span(split).subspan(333));
+        for(size_t i = 0; i < out.size(); i++) passed &= out[i].v == split[i].v;
+        
+        r.reset();
+        r.process(in_view, std::span(split));
+        for(size_t i = 0; i < out.size(); i++) passed &= out[i].v == split[i].v;
+        
+        //every output is within a few lsb of the input
+        for(size_t i = 0; i < out.size(); i++) passed &= std::abs((static_cast<int32_t>(out[i].v) << 9) - signal[i].v) <= 5 << 9;
+    }
+    if(!passed) log_msg("failed requantize determinism test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //dither removes the bias of a value between two target values
+        std::vector<wide_sample> constant(100000, fp_from_bits<int32_t, 24>(1000 * 512 + 154));
+        std::vector<narrow_sample> constant_out(constant.size());
+        std::span<const wide_sample> constant_view(constant);
+        for(auto mode : {dither_mode::rectangular, dither_mode::triangular}){
+            requantize<narrow_sample, 0>(constant_view, std::span(constant_out), 1, mode, 3);
+            int64_t sum = 0;
+            for(auto x : constant_out) sum += x.v - 1000;
+            double mean = static_cast<double>(sum) / static_cast<double>(constant.size());
+            passed &= std::abs(mean - 154.0 / 512.0) < 0.01;
+        }
+        requantize<narrow_sample, 0>(constant_view, std::span(constant_out), 1, dither_mode::none);
+        passed &= constant_out[0].v == 1000 and constant_out.back().v == 1000;
+    }
+    if(!passed) log_msg("failed requantize dither test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //noise shaping moves the error out of the low frequencies
+        std::vector<narrow_sample> shaped(signal.size());
+        requantize<narrow_sample, 0>(in_view, std::span(out), 1, dither_mode::triangular, 11);
+        double flat = low_frequency_error(signal, out);
+        requantize<narrow_sample, 1>(in_view, std::span(shaped), 1, dither_mode::triangular, 11);
+        double first = low_frequency_error(signal, shaped);
+        requantize<narrow_sample, 3>(in_view, std::span(shaped), 1, dither_mode::triangular, 11);
+        double third = low_frequency_error(signal, shaped);
+        passed &= first * 20.0 < flat and third * 20.0 < flat;
+        
+        //with first order feedback the total error telescopes to the error of the last sample
+        requantize<narrow_sample, 1>(in_view, std::span(shaped), 1, dither_mode::triangular, 11);
+        int64_t total = 0;
+        for(size_t i = 0; i < signal.size(); i++) total += (static_cast<int64_t>(shaped[i].v) << 9) - signal[i].v;
+        passed &= std::abs(total) <= 3 * 256;
+    }
+    if(!passed) log_msg("failed requantize noise shaping test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //clipped input saturates and the filter recovers right after it
+        std::vector<wide_sample> clipped(400, make_fixed<int32_t, 24>(4));
+        clipped.resize(800, fp_from_bits<int32_t, 24>(1 << 22));
+        std::vector<narrow_sample> clipped_out(clipped.size());
+        requantize<narrow_sample, 3>(std::span<const wide_sample>(clipped), std::span(clipped_out), 1, dither_mode::triangular, 5);
+        passed &= clipped_out[0].v == 0x7fff and clipped_out[399].v == 0x7fff;
+        for(size_t i = 410; i < clipped.size(); i++) passed &= std::abs(clipped_out[i].v - (1 << 13)) <= 12;
+    }
+    if(!passed) log_msg("failed requantize saturation test!");
+    all_passed &= passed;
+    
+    passed = true;
+    {
+        //channels of interleaved frames are shaped independently
+        std::vector<wide_sample> stereo(2 * 5000);
+        for(size_t i = 0; i < 5000; i++){
+            stereo[2 * i] = signal[i];
+            stereo[2 * i + 1] = signal[i + 7000];
+        }
+        std::vector<narrow_sample> stereo_out(stereo.size());
+        std::vector<narrow_sample> left(5000);
+        std::vector<narrow_sample> right(5000);
+        requantize<narrow_sample, 2>(std::span<const wide_sample>(stereo), std::span(stereo_out), 2, dither_mode::none);
+        requantize<narrow_sample, 2>(in_view.first(5000), std::span(left), 1, dither_mode::none);
+        requantize<narrow_sample, 2>(in_view.subspan(7000, 5000), std::span(right), 1, dither_mode::none);
+        for(size_t i = 0; i < 5000; i++) passed &= stereo_out[2 * i].v == left[i].v and stereo_out[2 * i + 1].v == right[i].v;
+        
+        std::vector<fixed<int8_t, 7>> bytes(stereo.size());
+        requantize<fixed<int8_t, 7>, 1>(std::span<const wide_sample>(stereo), std::span(bytes), 2);
+        for(size_t i = 0; i < stereo.size(); i++) passed &= std::abs((static_cast<int32_t>(bytes[i].v) << 17) - stereo[i].v) <= 3 << 17;
+    }
+    if(!passed) log_msg("failed requantize channel test!");
+    all_passed &= passed;
+    
+    return all_passed;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "test_sort.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_sort.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> random_values(size_t n, uint64_t seed){
+    std::vector<fixed<T, fraction>> result(n);
+    for(auto& x : result){
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        x.v = static_cast<T>(seed >> 17);
+    }
+    return result;
+}
+
+template<typename T, size_t fraction>
+bool test_radix_sort_impl(size_t n, size_t threads){
+    auto values = random_values<T, fraction>(n, n + threads);
+    auto expected = values;
+    std::stable_sort(expected.begin(), expected.end());
+    radix_sort(std::span(values), threads);
+    return values == expected;
+}
+
+bool test_sort(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    passed &= test_radix_sort_impl<int32_t, 16>(10000, 1);
+    passed &= test_radix_sort_impl<int32_t, 16>(10001, 4);
+    passed &= test_radix_sort_impl<uint16_t, 8>(777, 3);
+    passed &= test_radix_sort_impl<int8_t, 4>(300, 2);
+    passed &= test_radix_sort_impl<int64_t, 32>(5000, 8);
+    {
+        //only the low byte differs, the other passes are skipped
+        std::vector<fixed<int32_t, 16>> small(100);
+        for(size_t i = 0; i < small.size(); i++) small[i].v = static_cast<int32_t>((i * 37) % 100) - 50;
+        auto expected = small;
+        std::sort(expected.begin(), expected.end());
+        radix_sort(std::span(small));
+        passed &= small == expected;
+    }
+    if(!passed) log_msg("failed radix sort test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        auto values = random_values<int32_t, 16>(1000, 7);
+        //duplicates make lower and upper bound differ
+        for(size_t i = 0; i < values.size(); i += 3) values[i] = values[i / 2];
+        std::sort(values.begin(), values.end());
+        std::span<const fixed<int32_t, 16>> sorted(values);
+        auto queries = random_values<int32_t, 16>(203, 8);
+        for(size_t i = 0; i < queries.size(); i += 2) queries[i] = values[(i * 13) % values.size()];
+        std::vector<size_t> batch(queries.size());
+        lower_bound(sorted, std::span<const fixed<int32_t, 16>>(queries), std::span(batch));
+        for(size_t i = 0; i < queries.size(); i++){
+            size_t lo = static_cast<size_t>(std::lower_bound(values.begin(), values.end(), queries[i]) - values.begin());
+            size_t hi = static_cast<size_t>(std::upper_bound(values.begin(), values.end(), queries[i]) - values.begin());
+            passed &= lower_bound(sorted, queries[i]) == lo and batch[i] == lo;
+            passed &= upper_bound(sorted, queries[i]) == hi;
+        }
+        passed &= lower_bound(std::span<const fixed<int32_t, 16>>(), queries[0]) == 0;
+        if(!passed) log_msg("failed binary search test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        auto values = random_values<int32_t, 16>(999, 9);
+        for(size_t i = 0; i < values.size(); i += 5) values[i] = values[0];
+        auto sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        std::span<const fixed<int32_t, 16>> view(values);
+        for(size_t k : {size_t{0}, size_t{1}, size_t{100}, size_t{499}, size_t{998}}) passed &= select_nth(view, k) == sorted[k];
+        passed &= median(view) == sorted[499];
+        passed &= percentile(view, 0.0) == sorted[0] and percentile(view, 1.0) == sorted[998];
+        passed &= percentile(view, 0.9) == sorted[899];
+        
+        auto unsigned_values = random_values<uint16_t, 4>(100, 3);
+        auto unsigned_sorted = unsigned_values;
+        std::sort(unsigned_sorted.begin(), unsigned_sorted.end());
+        passed &= median(std::span<const fixed<uint16_t, 4>>(unsigned_values)) == unsigned_sorted[49];
+        
+        auto partitioned = values;
+        nth_element(std::span(partitioned), 300);
+        passed &= partitioned[300] == sorted[300];
+        passed &= std::all_of(partitioned.begin(), partitioned.begin() + 300, [&](auto x){ return x <= sorted[300]; });
+        passed &= std::all_of(partitioned.begin() + 301, partitioned.end(), [&](auto x){ return x >= sorted[300]; });
+        if(!passed) log_msg("failed selection test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_stats.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_stats.hpp"
+
+using namespace fixed_point;
+
+template<typename T, size_t fraction>
+std::vector<fixed<T, fraction>> stats_values(size_t n, uint64_t seed){
+    std::vector<fixed<T, fraction>> result(n);
+    for(auto& x : result){
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        x.v = static_cast<T>(seed >> 40);
+    }
+    return result;
+}
+
+//mean and variance in units of the last fractional bit, computed in long double
+template<typename T, size_t fraction>
+bool check_stats(const std::vector<fixed<T, fraction>>& values, const running_stats<T, fraction>& stats){
+    long double sum = 0;
+    for(auto x : values) sum += x.v;
+    long double mean = sum / values.size();
+    long double deviation = 0;
+    for(auto x : values) deviation += (x.v - mean) * (x.v - mean);
+    long double variance = deviation / values.size() / (1 << fraction);
+    long double stddev = std::sqrt(deviation / values.size());
+    bool passed = true;
+    passed &= stats.count() == values.size();
+    passed &= std::abs(stats.mean().v - mean) <= 0.5L;
+    passed &= std::abs(stats.variance().v - variance) <= 0.5L;
+    passed &= std::abs(stats.stddev().v - stddev) <= 1.0L;
+    passed &= stats.min() == *std::min_element(values.begin(), values.end());
+    passed &= stats.max() == *std::max_element(values.begin(), values.end());
+    return passed;
+}
+
+bool test_stats(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = true;
+    {
+        //values far from zero with a tiny spread, where the naive float formula cancels
+        auto values = stats_values<int32_t, 16>(10000, 1);
+        for(auto& x : values) x.v = (x.v & 0xff) + 2000000000;
+        running_stats<int32_t, 16> one_by_one;
+        for(auto x : values) one_by_one.add(x);
+        running_stats<int32_t, 16> batch;
+        batch.add(std::span<const fixed<int32_t, 16>>(values));
+        passed &= check_stats(values, one_by_one) and check_stats(values, batch);
+        passed &= one_by_one.raw_sum() == batch.raw_sum() and one_by_one.variance() == batch.variance();
+        
+        //per thread partial states merge to the same result
+        running_stats<int32_t, 16> first;
+        running_stats<int32_t, 16> second;
+        first.add(std::span<const fixed<int32_t, 16>>(values).first(3333));
+        second.add(std::span<const fixed<int32_t, 16>>(values).subspan(3333));
+        first.merge(second);
+        passed &= first.raw_sum() == batch.raw_sum() and first.variance() == batch.variance() and first.min() == batch.min();
+    }
+    {
+        //the variance of fixed<int16_t, 8> must fit into the type itself
+        auto values = stats_values<int16_t, 8>(5000, 2);
+        for(auto& x : values) x.v = static_cast<int16_t>(x.v >> 4);
+        running_stats<int16_t, 8> stats;
+        stats.add(std::span<const fixed<int16_t, 8>>(values));
+        passed &= check_stats(values, stats);
+        
+        auto samples = std::vector{make_fixed<int16_t, 8>(1), make_fixed<int16_t, 8>(2), make_fixed<int16_t, 8>(3), make_fixed<int16_t, 8>(6)};
+        running_stats<int16_t, 8> small;
+        small.add(std::span<const fixed<int16_t, 8>>(samples));
+        passed &= small.mean() == make_fixed<int16_t, 8>(3);
+        passed &= small.variance() == fixed<int16_t, 8>(3.5_fixp_t);
+        passed &= small.sample_variance() == fp_from_bits<int16_t, 8>(1195); //14 / 3
+        small.reset();
+        passed &= small.count() == 0;
+    }
+    {
+        auto values = stats_values<int64_t, 32>(3000, 3);
+        for(auto& x : values) x.v *= 1 << 20;
+        running_stats<int64_t, 32> stats;
+        stats.add(std::span<const fixed<int64_t, 32>>(values));
+        passed &= stats.count() == 3000 and stats.min() == *std::min_element(values.begin(), values.end());
+        long double sum = 0;
+        for(auto x : values) sum += x.v;
+        passed &= std::abs(stats.mean().v - sum / 3000) < 1e-6L * std::abs(sum / 3000) + 1;
+        
+        auto unsigned_values = stats_values<uint16_t, 4>(1000, 4);
+        for(auto& x : unsigned_values) x.v = static_cast<uint16_t>(x.v >> 8);
+        running_stats<uint16_t, 4> unsigned_stats;
+        for(auto x : unsigned_values) unsigned_stats.add(x);
+        passed &= check_stats(unsigned_values, unsigned_stats);
+    }
+    if(!passed) log_msg("failed running stats test!");
+    all_passed &= passed;
+    
+    {
+        passed = true;
+        ewma_shift<int32_t, 16, 4> shifted;
+        shifted.add(make_fixed<int32_t, 16>(0));
+        shifted.add(make_fixed<int32_t, 16>(16));
+        passed &= shifted.value() == make_fixed<int32_t, 16>(1);
+        //a constant input is reached exactly
+        for(int i = 0; i < 1000; i++) shifted.add(fixed<int32_t, 16>(2.5_fixp_t));
+        passed &= shifted.value() == fixed<int32_t, 16>(2.5_fixp_t);
+        
+        ewma<int32_t, 16> averaged(ewma<int32_t, 16>::alpha_for_window(3));
+        passed &= ewma<int32_t, 16>::alpha_for_window(1).v == 1 << 30;
+        passed &= ewma<int32_t, 16>::alpha_for_window(3).v == 1 << 29;
+        averaged.add(make_fixed<int32_t, 16>(8));
+        averaged.add(make_fixed<int32_t, 16>(0));
+        averaged.add(make_fixed<int32_t, 16>(0));
+        passed &= averaged.value() == make_fixed<int32_t, 16>(2);
+        auto constant = std::vector(500, fixed<int32_t, 16>(-7.25_fixp_t));
+        averaged.add(std::span<const fixed<int32_t, 16>>(constant));
+        passed &= averaged.value() == fixed<int32_t, 16>(-7.25_fixp_t);
+        
+        //matches the same recursion in double
+        ewma<int32_t, 16> tracked(ewma<int32_t, 16>::alpha_for_window(20));
+        auto values = stats_values<int32_t, 16>(2000, 5);
+        double reference = values[0].v;
+        double alpha = ewma<int32_t, 16>::alpha_for_window(20).v / double(1 << 30);
+        for(size_t i = 0; i < values.size(); i++){
+            tracked.add(values[i]);
+            if(i > 0) reference += alpha * (values[i].v - reference);
+        }
+        passed &= std::abs(tracked.value().v - reference) <= 1.0;
+        if(!passed) log_msg("failed ewma test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        auto values = stats_values<int32_t, 16>(3000, 6);
+        for(size_t window : {size_t{1}, size_t{7}, size_t{64}}){
+            windowed_minmax<int32_t, 16> extrema(window);
+            for(size_t i = 0; i < values.size(); i++){
+                extrema.add(values[i]);
+                auto first = values.begin() + static_cast<ptrdiff_t>(i + 1 - std::min(i + 1, window));
+                auto last = values.begin() + static_cast<ptrdiff_t>(i + 1);
+                passed &= extrema.min() == *std::min_element(first, last);
+                passed &= extrema.max() == *std::max_element(first, last);
+            }
+            passed &= extrema.size() == window;
+        }
+        windowed_minmax<int32_t, 16> sorted(5);
+        std::vector<fixed<int32_t, 16>> ascending(20);
+        for(size_t i = 0; i < ascending.size(); i++) ascending[i] = make_fixed<int32_t, 16>(static_cast<int>(i));
+        sorted.add(std::span<const fixed<int32_t, 16>>(ascending));
+        passed &= sorted.min() == make_fixed<int32_t, 16>(15) and sorted.max() == make_fixed<int32_t, 16>(19);
+        sorted.reset();
+        sorted.add(make_fixed<int32_t, 16>(-1));
+        passed &= sorted.size() == 1 and sorted.min() == sorted.max();
+        if(!passed) log_msg("failed windowed min max test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
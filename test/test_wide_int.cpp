@@ -0,0 +1,170 @@
+#include <cstdint>
+#include <string_view>
+
+#include "test_wide_int.hpp"
+#include "test_helper.hpp"
+#include "fixed_point_math.hpp"
+
+using namespace fixed_point;
+
+__extension__ using int128 = __int128;
+
+namespace{
+
+struct test_rng{
+    uint64_t state = 0x9e3779b97f4a7c15;
+    
+    uint64_t next(){
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    
+    template<size_t bits>
+    wide_int<bits> wide(size_t used_limbs){
+        wide_int<bits> result = 0;
+        for(size_t i = 0; i < used_limbs; i++) result.limbs[i] = next();
+        return result;
+    }
+};
+
+wide_int<128> from_int128(int128 x){
+    wide_int<128> result;
+    result.limbs[0] = static_cast<uint64_t>(x);
+    result.limbs[1] = static_cast<uint64_t>(x >> 64);
+    return result;
+}
+
+}//namespace
+
+bool test_wide_int_arithmetic(){
+    bool passed = true;
+    test_rng rng;
+    for(int i = 0; i < 2000; i++){
+        int128 a = static_cast<int128>((static_cast<unsigned __int128>(rng.next()) << 64) | rng.next());
+        int128 b = static_cast<int128>((static_cast<unsigned __int128>(rng.next()) << 64) | rng.next());
+        //shorter divisors exercise the short division and different quotient lengths
+        b >>= rng.next() % 120;
+        if(b == 0) b = 7;
+        auto wa = from_int128(a);
+        auto wb = from_int128(b);
+        passed &= wa + wb == from_int128(static_cast<int128>(static_cast<unsigned __int128>(a) + static_cast<unsigned __int128>(b)));
+        passed &= wa - wb == from_int128(static_cast<int128>(static_cast<unsigned __int128>(a) - static_cast<unsigned __int128>(b)));
+        passed &= wa * wb == from_int128(static_cast<int128>(static_cast<unsigned __int128>(a) * static_cast<unsigned __int128>(b)));
+        passed &= wa / wb == from_int128(a / b);
+        passed &= wa % wb == from_int128(a % b);
+        int shift = static_cast<int>(rng.next() % 128);
+        passed &= (wa >> shift) == from_int128(a >> shift);
+        passed &= (wa << shift) == from_int128(static_cast<int128>(static_cast<unsigned __int128>(a) << shift));
+        passed &= (wa < wb) == (a < b) and (wa == wb) == (a == b);
+    }
+    return passed;
+}
+
+bool test_wide_int_large(){
+    bool passed = true;
+    test_rng rng;
+    for(int i = 0; i < 200; i++){
+        //karatsuba for 512 bit factors against the plain schoolbook product
+        auto a = rng.wide<512>(8);
+        auto b = rng.wide<512>(8);
+        auto fast = detail::multiply_full(a.limbs, b.limbs);
+        auto slow = detail::schoolbook_multiply(a.limbs, b.limbs);
+        passed &= fast == slow;
+        
+        //signed widening product
+        auto product = wide_product(a, b);
+        passed &= wide_int<512>(product) == a * b;
+        passed &= product / wide_int<1024>(b) == wide_int<1024>(a);
+        
+        //division identity for random lengths
+        auto n = rng.wide<256>(1 + rng.next() % 4);
+        auto d = rng.wide<256>(1 + rng.next() % 4);
+        if(rng.next() & 1) n = -n;
+        if(rng.next() & 1) d = -d;
+        if(d == 0) d = 3;
+        auto q = n / d;
+        auto r = n % d;
+        passed &= q * d + r == n;
+        passed &= abs(r) < abs(d);
+        passed &= r == 0 or r.is_negative() == n.is_negative();
+    }
+    
+    static_assert(wide_int<256>(-5) / 2 == -2 and wide_int<256>(-5) % 2 == -1);
+    static_assert((wide_uint<128>(1) << 100) >> 99 == 2);
+    static_assert(std::numeric_limits<wide_int<256>>::digits == 255 and std::numeric_limits<wide_uint<256>>::digits == 256);
+    static_assert(std::numeric_limits<wide_int<128>>::max() + 1 == std::numeric_limits<wide_int<128>>::min());
+    static_assert(std::numeric_limits<wide_int<128>>::digits10 == 38);
+    static_assert(leading_zeros(wide_uint<256>(1) << 70) == 185 and leading_zeros(wide_int<128>(-1)) == 0);
+    static_assert(static_cast<double>(wide_int<128>(-3) << 70) == -3.0 * 1180591620717411303424.0);
+    return passed;
+}
+
+bool test_wide_fixed(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    {
+        passed = true;
+        using f64 = fixed<int64_t, 32>;
+        f64 a = 1.5_fixp_t;
+        f64 b = -2.25_fixp_t;
+        passed &= a * b == f64(-3.375_fixp_t);
+        passed &= b / a == f64(-1.5_fixp_t);
+        passed &= correctly_rounded_division(f64(1), f64(3)).v == 1431655765;
+        //sqrt(2) * 2^32 = 6074001000.31...
+        passed &= sqrt(f64(2)).v == 6074001000;
+        auto text = f64(-12.5_fixp_t).to_string();
+        passed &= std::string_view(text.data()).starts_with("-12.5000");
+        if(!passed) log_msg("failed 64 bit fixed test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using f128 = fixed<wide_int<128>, 64>;
+        constexpr f128 a = 3.25_fixp_t;
+        constexpr f128 product = a * f128(-4);
+        static_assert(product == f128(-13));
+        f128 x = 2;
+        //sqrt(2) = 1.6a09e667f3bcc908b2f...
+        auto root = sqrt(x);
+        passed &= root.v.limbs[1] == 1 and root.v.limbs[0] == 0x6a09e667f3bcc909;
+        passed &= f128(1) / f128(3) * f128(3) == f128(1) - fp_from_bits<wide_int<128>, 64>(1);
+        auto text = f128(-0.75_fixp_t).to_string();
+        passed &= std::string_view(text.data()).starts_with("-0.75000000000");
+        if(!passed) log_msg("failed 128 bit fixed test!");
+        all_passed &= passed;
+    }
+    
+    {
+        passed = true;
+        using f256 = fixed<wide_int<256>, 160>;
+        f256 third = correctly_rounded_division(f256(1), f256(3));
+        //2^160 = 3 q + 1, so the correctly rounded third is q and three of them are one ulp short of 1
+        passed &= third.v == (wide_int<256>(1) << 160) / 3;
+        passed &= third * f256(3) == f256(1) - fp_from_bits<wide_int<256>, 160>(1);
+        passed &= sqrt(f256(16)) == f256(4);
+        if(!passed) log_msg("failed 256 bit fixed test!");
+        all_passed &= passed;
+    }
+    
+    return all_passed;
+}
+
+bool test_wide_int(){
+    bool all_passed = true;
+    bool passed = true;
+    
+    passed = test_wide_int_arithmetic();
+    if(!passed) log_msg("failed wide_int arithmetic test!");
+    all_passed &= passed;
+    
+    passed = test_wide_int_large();
+    if(!passed) log_msg("failed wide_int large test!");
+    all_passed &= passed;
+    
+    all_passed &= test_wide_fixed();
+    return all_passed;
+}